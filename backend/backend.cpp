@@ -1,5 +1,12 @@
 #include "backend.h"
 #include "rtspcamera.h"
+#include "localframeserver.h"
+#include "syntheticlinecamera.h"
+#include "linescanassembler.h"
+#include "imagequalityanalyzer.h"
+#include <QWebChannel>
+#include <QWebEnginePage>
+#include <QWebEngineProfile>
 #include <QDebug>
 #include <QAbstractSocket>
 #include <QJsonDocument>
@@ -22,6 +29,26 @@ Backend::Backend(QWebEngineView* view, QObject* parent)
         qDebug() << "سرور WebSocket روی پورت 12345 شروع به کار کرد";
     }
 
+    // In-process frame path for the embedded view (no loopback WebSocket/base64)
+    localFrameServer = new LocalFrameServer(this);
+    webChannel = new QWebChannel(this);
+    webChannel->registerObject(QStringLiteral("frames"), localFrameServer);
+    if (view) {
+        view->page()->profile()->installUrlSchemeHandler(LocalFrameServer::schemeName, localFrameServer);
+        view->page()->setWebChannel(webChannel);
+    }
+
+    // Background quality analyzer; results are pushed to all clients
+    qualityAnalyzer = new ImageQualityAnalyzer(this);
+    connect(qualityAnalyzer, &ImageQualityAnalyzer::metricsUpdated, this, [this](const QJsonObject& metrics) {
+        broadcastMessage("quality:" + QString::fromUtf8(QJsonDocument(metrics).toJson(QJsonDocument::Compact)));
+    });
+    connect(qualityAnalyzer, &ImageQualityAnalyzer::alertRaised, this, [this](const QJsonObject& alert) {
+        qDebug() << "Quality alert:" << alert.value("message").toString() << alert.value("value").toDouble();
+        broadcastMessage("qualityAlert:" + QString::fromUtf8(QJsonDocument(alert).toJson(QJsonDocument::Compact)));
+    });
+    qualityAnalyzer->start();
+
     timer = new QTimer(this);
     connect(timer, &QTimer::timeout, this, &Backend::processFrames);
 
@@ -66,7 +93,9 @@ Backend::~Backend() {
     for (QWebSocket* client : clients) {
         client->deleteLater();
     }
+    qualityAnalyzer->stop();
     qDeleteAll(cameras);
+    delete lineScanAssembler; // lineScanCamera is a child and stops its own thread
     webSocketServer->close();
     qDebug() << "Backend آزاد شد";
 }
@@ -89,11 +118,14 @@ void Backend::onClientDisconnected() {
     QWebSocket* client = qobject_cast<QWebSocket*>(sender());
     if (client) {
         clients.removeAll(client);
+        localClients.remove(client);
+        displaySettings.remove(client);
         client->deleteLater();
         qDebug() << "کلاینت قطع شد. تعداد:" << clients.size();
 
         if (clients.isEmpty()) {
             timer->stop();
+            stopLineScan(); // Nobody left to stream to; don't keep acquiring in the background
             qDebug() << "تایمر متوقف شد - هیچ کلاینتی متصل نیست";
         }
     }
@@ -227,15 +259,60 @@ void Backend::encodeAndSendFrame(cv::Mat& frame, const QString& channel) {
         return;
     }
 
+    // Split clients into default stream and per-parameter-set display groups.
+    // Window/level and colormaps only apply to the detector channel, never to
+    // the colour cabin camera.
+    const bool detectorChannel = (channel == displayChannel);
+    QList<QWebSocket*> defaultClients;
+    QMap<DisplayParams, QList<QWebSocket*>> displayGroups;
+    for (QWebSocket* client : clients) {
+        auto it = displaySettings.constFind(client);
+        if (detectorChannel && it != displaySettings.constEnd()) {
+            displayGroups[*it] << client;
+        } else {
+            defaultClients << client;
+        }
+    }
+
+    // Server-side window/level/colormap: one LUT pass and one encode per parameter set
+    for (auto it = displayGroups.constBegin(); it != displayGroups.constEnd(); ++it) {
+        cv::Mat displayFrame = displayPipeline.render(frame, it.key());
+        QByteArray displayData;
+        if (encodeJpeg(displayFrame, channel, displayData)) {
+            sendImage(channel, displayData, it.value(), false);
+        }
+    }
+
+    if (defaultClients.isEmpty()) {
+        return;
+    }
+
     // Check if frame has changed significantly (skip encoding if not)
     if (!hasFrameChanged(frame, channel)) {
         // Reuse cached encoded frame
         if (lastEncodedFrames.contains(channel)) {
-            sendImage(channel, lastEncodedFrames[channel]);
+            sendImage(channel, lastEncodedFrames[channel], defaultClients);
             return;
         }
     }
 
+    QByteArray byteArray;
+    if (!encodeJpeg(frame, channel, byteArray)) {
+        return;
+    }
+
+    // Cache the frame and encoded data
+    cacheFrame(frame, byteArray, channel);
+    
+    // Send the image
+    sendImage(channel, byteArray, defaultClients);
+}
+
+bool Backend::encodeJpeg(const cv::Mat& frame, const QString& channel, QByteArray& encodedData) {
+    if (frame.empty()) {
+        return false;
+    }
+
     // Use static buffers to avoid repeated allocations
     static thread_local std::vector<uchar> buffer;
     buffer.clear();
@@ -257,25 +334,39 @@ void Backend::encodeAndSendFrame(cv::Mat& frame, const QString& channel) {
 
     if (!cv::imencode(".jpg", frame, buffer, encodeParams)) {
         qDebug() << "خطا: رمزگذاری JPEG برای کانال" << channel << "ناموفق بود";
-        return;
+        return false;
     }
 
-    // Create byte array and cache it
-    QByteArray byteArray(reinterpret_cast<const char*>(buffer.data()), 
-                         static_cast<int>(buffer.size()));
-    
-    // Cache the frame and encoded data
-    cacheFrame(frame, byteArray, channel);
-    
-    // Send the image
-    sendImage(channel, byteArray);
+    encodedData = QByteArray(reinterpret_cast<const char*>(buffer.data()), 
+                             static_cast<int>(buffer.size()));
+    return true;
 }
 
-void Backend::sendImage(const QString& channel, const QByteArray& imageData) {
-    if (clients.isEmpty()) {
+void Backend::sendImage(const QString& channel, const QByteArray& imageData, const QList<QWebSocket*>& targets,
+                        bool defaultStream) {
+    if (targets.isEmpty()) {
         return;
     }
 
+    // Local view picks the frame up by reference through ct2frame:<channel>
+    int remoteCount = 0;
+    bool hasLocalTarget = false;
+    for (QWebSocket* client : targets) {
+        if (localClients.contains(client)) {
+            hasLocalTarget = true;
+        } else {
+            remoteCount++;
+        }
+    }
+    // Until the embedded view opts in, publish the default stream so it can probe the
+    // local path; another client's windowed/colormapped frames must not leak into it
+    if (hasLocalTarget || (defaultStream && localClients.isEmpty())) {
+        localFrameServer->publishFrame(channel, imageData);
+    }
+    if (remoteCount == 0) {
+        return; // No remote clients - skip base64 encoding entirely
+    }
+
     // Use static buffer for base64 encoding to avoid repeated allocations
     static thread_local QByteArray base64Buffer;
     base64Buffer.clear();
@@ -292,15 +383,15 @@ void Backend::sendImage(const QString& channel, const QByteArray& imageData) {
 
     // Send to connected clients only (disconnected ones handled by periodic cleanup)
     int sentCount = 0;
-    for (QWebSocket* client : clients) {
-        if (client->state() == QAbstractSocket::ConnectedState) {
+    for (QWebSocket* client : targets) {
+        if (client->state() == QAbstractSocket::ConnectedState && !localClients.contains(client)) {
             client->sendTextMessage(messageBuffer);
             sentCount++;
         }
     }
     
     // Optional: Log if no clients received the message
-    if (sentCount == 0 && !clients.isEmpty()) {
+    if (sentCount == 0) {
         qDebug() << "Warning: No active clients to receive" << channel << "frame";
     }
 }
@@ -349,11 +440,21 @@ void Backend::processFrames() {
         }
     }
 
-    // Process fake Basler camera
+    // Process Basler camera (fake frames unless a detector is registered)
     QString baslerChannel = "basler";
     if (currentTime - lastFrameTime[baslerChannel] >= cameraIntervals[baslerChannel]) {
-        cv::Mat fakeFrame = createFakeFrame("basler", frameCounter);
-        encodeAndSendFrame(fakeFrame, baslerChannel);
+        Camera* baslerCamera = getCameraByChannel(baslerChannel);
+        cv::Mat frame;
+
+        if (baslerCamera && baslerCamera->isConnected() && baslerCamera->grabFrame(frame) && !frame.empty()) {
+            qualityAnalyzer->submitFrame(frame, baslerChannel);
+            encodeAndSendFrame(frame, baslerChannel);
+        } else {
+            // Fallback frames keep the quality views live, flagged as simulated
+            cv::Mat fakeFrame = createFakeFrame("basler", frameCounter);
+            qualityAnalyzer->submitFrame(fakeFrame, baslerChannel, true);
+            encodeAndSendFrame(fakeFrame, baslerChannel);
+        }
         cameraFailed[baslerChannel] = false;
         anyActive = true;
         processedFrames++;
@@ -362,11 +463,20 @@ void Backend::processFrames() {
         anyActive = true; // Basler fake is always considered active
     }
 
+    processLineScan(currentTime);
+
     // Performance monitoring (every 10 seconds)
     if (currentTime - lastPerformanceReport >= 10000) {
         double fps = processedFrames / 10.0;
         qDebug() << "Performance: Processed" << processedFrames << "frames in 10s, avg FPS:" << fps;
+        if (lineScanCamera) {
+            qint64 dropped = lineScanCamera->getDroppedLines();
+            qDebug() << "Performance: Line scan avg" << lineScanLines / 10.0 << "lines/s, dropped"
+                     << dropped - lineScanDroppedReported << "lines";
+            lineScanDroppedReported = dropped;
+        }
         processedFrames = 0;
+        lineScanLines = 0;
         lastPerformanceReport = currentTime;
     }
     
@@ -426,10 +536,16 @@ void Backend::cleanupDisconnectedClients() {
     if (!disconnectedClients.isEmpty()) {
         for (QWebSocket* client : disconnectedClients) {
             clients.removeAll(client);
+            localClients.remove(client);
+            displaySettings.remove(client);
             client->deleteLater();
         }
         qDebug() << "Periodic cleanup: removed" << disconnectedClients.size() << "disconnected clients";
         qDebug() << "Active clients:" << clients.size();
+
+        if (clients.isEmpty()) {
+            stopLineScan();
+        }
     }
 }
 
@@ -463,6 +579,54 @@ void Backend::onTextMessageReceived(const QString& message) {
         } else {
             sendResponse("Error: Invalid JSON");
         }
+    } else if (type == "LineScan") {
+        QJsonDocument doc = QJsonDocument::fromJson(data.toUtf8());
+        if (doc.isNull() || !doc.isObject()) {
+            sendResponse("Error: Invalid JSON");
+            return;
+        }
+        QString action = doc.object().value("action").toString();
+        if (action == "start") {
+            startLineScan(doc.object());
+        } else if (action == "stop") {
+            stopLineScan();
+        } else {
+            sendResponse("Error: Unknown LineScan action");
+        }
+    } else if (type == "QualityConfig") {
+        QJsonDocument doc = QJsonDocument::fromJson(data.toUtf8());
+        if (doc.isNull() || !doc.isObject()) {
+            sendResponse("Error: Invalid JSON");
+            return;
+        }
+        qualityAnalyzer->setConfig(QualityConfig::fromJson(doc.object(), qualityAnalyzer->getConfig()));
+        sendResponse("Quality monitor configured");
+    } else if (type == "FrameTransport") {
+        // Embedded view switches to the in-process frame path
+        QWebSocket* client = qobject_cast<QWebSocket*>(sender());
+        if (client) {
+            if (data == "local") {
+                localClients.insert(client);
+            } else {
+                localClients.remove(client);
+            }
+            qDebug() << "Frame transport for client:" << data << "- local clients:" << localClients.size();
+        }
+    } else if (type == "DisplaySettings") {
+        // Per-client server-side display stage for the detector channel;
+        // empty object resets to the default stream
+        QWebSocket* client = qobject_cast<QWebSocket*>(sender());
+        QJsonDocument doc = QJsonDocument::fromJson(data.toUtf8());
+        if (!client) {
+            return;
+        }
+        if (doc.isNull() || !doc.isObject()) {
+            sendResponse("Error: Invalid JSON");
+        } else if (doc.object().isEmpty()) {
+            displaySettings.remove(client);
+        } else {
+            displaySettings[client] = DisplayParams::fromJson(doc.object());
+        }
     } else {
         qDebug() << "نوع پیام ناشناخته:" << type;
         sendResponse("پیام دریافت شد: " + type);
@@ -476,3 +640,138 @@ void Backend::sendResponse(const QString& response) {
         }
     }
 }
+
+void Backend::startLineScan(const QJsonObject& config) {
+    stopLineScan();
+
+    int width = std::clamp(config.value("width").toInt(1024), 16, 8192);
+    double lineRate = std::clamp(config.value("lineRate").toDouble(20000.0), 1.0, 200000.0);
+
+    SyntheticLineCamera* camera = new SyntheticLineCamera(width, lineRate, this);
+    if (!lineScanAssembler || lineScanAssembler->lineWidth() != width) {
+        delete lineScanAssembler;
+        lineScanAssembler = new LineScanAssembler(width);
+    }
+    lineScanAssembler->reset();
+    if (config.value("correction").toBool(true)) {
+        lineScanAssembler->setCorrection(camera->darkLine(), camera->gainLine());
+    } else {
+        lineScanAssembler->setCorrection(cv::Mat(), cv::Mat());
+    }
+
+    lineScanCamera = camera;
+    lineScanSentRows = 0;
+    lineScanLines = 0;
+    lineScanDroppedReported = 0;
+    lastLineScanSend = QDateTime::currentMSecsSinceEpoch();
+    lineScanCamera->startAcquisition();
+
+    if (!clients.isEmpty() && !timer->isActive()) {
+        timer->start(timerInterval);
+    }
+    sendLineScanStatus("started");
+    sendResponse(QString("Line scan started (%1): %2 px @ %3 Hz")
+                     .arg(lineScanCamera->isSimulated() ? "simulated" : "detector").arg(width).arg(lineRate));
+}
+
+void Backend::stopLineScan() {
+    if (!lineScanCamera) {
+        return;
+    }
+
+    lineScanCamera->stopAcquisition();
+
+    // Flush lines acquired before the stop
+    cv::Mat lines;
+    if (lineScanCamera->grabLines(lines) > 0 && lineScanAssembler) {
+        lineScanAssembler->append(lines);
+    }
+    sendLineScanRows();
+    sendLineScanStatus("stopped");
+
+    qDebug() << "Line scan متوقف شد - ردیف‌ها:" << (lineScanAssembler ? lineScanAssembler->rowCount() : 0)
+             << "dropped:" << lineScanCamera->getDroppedLines();
+    lineScanCamera->deleteLater();
+    lineScanCamera = nullptr;
+}
+
+void Backend::processLineScan(qint64 currentTime) {
+    if (!lineScanCamera || !lineScanAssembler) {
+        return;
+    }
+
+    // Reuse the grab buffer across ticks (hot path at tens of kHz)
+    static thread_local cv::Mat lines;
+    int count = lineScanCamera->grabLines(lines);
+    if (count > 0) {
+        lineScanLines += lineScanAssembler->append(lines);
+    }
+
+    if (currentTime - lastLineScanSend >= lineScanSendInterval) {
+        sendLineScanRows();
+        lastLineScanSend = currentTime;
+    }
+}
+
+void Backend::sendLineScanRows() {
+    if (!lineScanAssembler || clients.isEmpty()) {
+        return;
+    }
+
+    qint64 totalRows = lineScanAssembler->rowCount();
+    if (totalRows <= lineScanSentRows) {
+        return;
+    }
+
+    // The strip is a ring; rows overwritten before they were streamed are skipped
+    qint64 firstRow = lineScanAssembler->firstRow();
+    if (lineScanSentRows < firstRow) {
+        qDebug() << "Line scan: skipped" << firstRow - lineScanSentRows << "overwritten rows";
+        lineScanSentRows = firstRow;
+    }
+
+    // Only rows added since the last update are encoded and streamed
+    cv::Mat newRows = lineScanAssembler->rows(lineScanSentRows, totalRows);
+
+    static const DisplayParams stripParams = [] {
+        DisplayParams params;
+        params.bitDepth = 16;
+        params.windowCenter = 32768.0;
+        params.windowWidth = 65536.0;
+        return params;
+    }();
+    cv::Mat displayRows = displayPipeline.render(newRows, stripParams);
+
+    QByteArray encoded;
+    if (!encodeJpeg(displayRows, "linescan", encoded)) {
+        return;
+    }
+
+    // Format: linescan:<startRow>:<base64 JPEG of the new rows>
+    broadcastMessage(QString("linescan:%1:").arg(lineScanSentRows) +
+                     QString::fromLatin1(encoded.toBase64(QByteArray::Base64Encoding | QByteArray::OmitTrailingEquals)));
+    lineScanSentRows = totalRows;
+}
+
+void Backend::sendLineScanStatus(const QString& state) {
+    if (!lineScanCamera || clients.isEmpty()) {
+        return;
+    }
+
+    // Format: linescanStatus:{json}; source tells the UI whether rows come from a real detector
+    QJsonObject status;
+    status["state"] = state;
+    status["source"] = lineScanCamera->isSimulated() ? "simulated" : "detector";
+    status["width"] = lineScanCamera->lineWidth();
+    status["rows"] = static_cast<qint64>(lineScanAssembler ? lineScanAssembler->rowCount() : 0);
+    status["droppedLines"] = lineScanCamera->getDroppedLines();
+    broadcastMessage("linescanStatus:" + QString::fromUtf8(QJsonDocument(status).toJson(QJsonDocument::Compact)));
+}
+
+void Backend::broadcastMessage(const QString& message) {
+    for (QWebSocket* client : clients) {
+        if (client->state() == QAbstractSocket::ConnectedState) {
+            client->sendTextMessage(message);
+        }
+    }
+}
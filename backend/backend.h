@@ -9,9 +9,16 @@
 #include <QJsonObject>
 #include <QTimer>
 #include <QMap>
+#include <QSet>
 #include <opencv2/opencv.hpp>
+#include "displaypipeline.h"
 
 class Camera;
+class LineScanCamera;
+class LineScanAssembler;
+class ImageQualityAnalyzer;
+class LocalFrameServer;
+class QWebChannel;
 
 class Backend : public QObject {
     Q_OBJECT
@@ -30,16 +37,30 @@ private:
     void processInitialParameters(const QString& data);
     void sendResponse(const QString& response);
     cv::Mat createFakeFrame(const QString& cameraType, int frameNumber);
-    void sendImage(const QString& channel, const QByteArray& imageData);
+    void sendImage(const QString& channel, const QByteArray& imageData, const QList<QWebSocket*>& targets,
+                   bool defaultStream = true);
     void encodeAndSendFrame(cv::Mat& frame, const QString& channel);
+    bool encodeJpeg(const cv::Mat& frame, const QString& channel, QByteArray& encodedData);
     void checkCameraConnections();
     Camera* getCameraByChannel(const QString& channel);
     bool hasFrameChanged(const cv::Mat& newFrame, const QString& channel);
     void cacheFrame(const cv::Mat& frame, const QByteArray& encodedData, const QString& channel);
     void cleanupDisconnectedClients();
+    void startLineScan(const QJsonObject& config);
+    void stopLineScan();
+    void processLineScan(qint64 currentTime);
+    void sendLineScanRows();
+    void sendLineScanStatus(const QString& state);
+    void broadcastMessage(const QString& message);
 
     QWebSocketServer* webSocketServer;
     QList<QWebSocket*> clients;
+    QSet<QWebSocket*> localClients; // Clients receiving frames via LocalFrameServer
+    LocalFrameServer* localFrameServer;
+    QMap<QWebSocket*, DisplayParams> displaySettings; // Clients with server-side display stage
+    const QString displayChannel = "basler";          // Only the detector channel is windowed
+    DisplayPipeline displayPipeline;
+    QWebChannel* webChannel;
     QTimer* timer;
     QList<Camera*> cameras;
     int frameCounter;
@@ -66,6 +87,18 @@ private:
     QMap<QString, int> frameChangeThreshold; // Threshold for frame change detection
     QMap<QString, cv::Mat> lastRawFrames; // Cache raw frames for comparison
     
+    // Line-scan acquisition (linear detector)
+    LineScanCamera* lineScanCamera = nullptr;
+    LineScanAssembler* lineScanAssembler = nullptr;
+    qint64 lineScanSentRows = 0;       // Rows already streamed to clients
+    qint64 lastLineScanSend = 0;
+    const int lineScanSendInterval = 40; // Stream new rows at 25 Hz
+    qint64 lineScanLines = 0;          // Lines assembled since last performance report
+    qint64 lineScanDroppedReported = 0; // Camera drop count at last performance report
+
+    // Continuous image-quality / stability monitoring of the detector channel
+    ImageQualityAnalyzer* qualityAnalyzer;
+
     // Client connection management
     qint64 lastClientCleanup = 0;
     const int clientCleanupInterval = 30000; // Clean up every 30 seconds
@@ -0,0 +1,227 @@
+#include "displaypipeline.h"
+#include <QDebug>
+#include <algorithm>
+#include <array>
+#include <cmath>
+
+namespace {
+
+// 256-entry colormaps, generated at compile time (packed 0x00RRGGBB)
+using Palette = std::array<uint32_t, 256>;
+
+constexpr double absValue(double v) { return v < 0 ? -v : v; }
+
+constexpr uint32_t toByte(double v) {
+    return v <= 0.0 ? 0u : v >= 255.0 ? 255u : static_cast<uint32_t>(v + 0.5);
+}
+
+constexpr uint32_t packRgb(double r, double g, double b) {
+    return (toByte(r * 255.0) << 16) | (toByte(g * 255.0) << 8) | toByte(b * 255.0);
+}
+
+constexpr Palette makePalette(Colormap colormap) {
+    Palette palette{};
+    for (int i = 0; i < 256; ++i) {
+        double t = i / 255.0;
+        switch (colormap) {
+        case Colormap::Gray:
+            palette[i] = packRgb(t, t, t);
+            break;
+        case Colormap::Hot:
+            palette[i] = packRgb(3.0 * t, 3.0 * t - 1.0, 3.0 * t - 2.0);
+            break;
+        case Colormap::Jet:
+            palette[i] = packRgb(1.5 - absValue(4.0 * t - 3.0),
+                                 1.5 - absValue(4.0 * t - 2.0),
+                                 1.5 - absValue(4.0 * t - 1.0));
+            break;
+        case Colormap::Bone:
+            // Gray with a blue tint: (7 * gray + reversed hot) / 8
+            palette[i] = packRgb((7.0 * t + std::min(1.0, std::max(0.0, 3.0 * t - 2.0))) / 8.0,
+                                 (7.0 * t + std::min(1.0, std::max(0.0, 3.0 * t - 1.0))) / 8.0,
+                                 (7.0 * t + std::min(1.0, 3.0 * t)) / 8.0);
+            break;
+        }
+    }
+    return palette;
+}
+
+constexpr std::array<Palette, 4> palettes = {
+    makePalette(Colormap::Gray),
+    makePalette(Colormap::Hot),
+    makePalette(Colormap::Jet),
+    makePalette(Colormap::Bone),
+};
+
+static_assert(palettes[0][0] == 0x000000u && palettes[0][255] == 0xFFFFFFu, "gray palette endpoints");
+static_assert(palettes[1][255] == 0xFFFFFFu, "hot palette must end in white");
+
+Colormap colormapFromString(const QString& name) {
+    if (name == "hot") return Colormap::Hot;
+    if (name == "jet") return Colormap::Jet;
+    if (name == "bone") return Colormap::Bone;
+    return Colormap::Gray;
+}
+
+// Storage depths with a compiled LUT specialization
+int supportedBitDepth(int bitDepth) {
+    if (bitDepth <= 10) return 10;
+    if (bitDepth <= 12) return 12;
+    if (bitDepth <= 14) return 14;
+    return 16;
+}
+
+} // namespace
+
+DisplayParams DisplayParams::fromJson(const QJsonObject& json) {
+    DisplayParams params;
+    params.bitDepth = std::clamp(json.value("bitDepth").toInt(params.bitDepth), 8, 16);
+
+    // Accept both center/width and the histogram's min/max levels
+    if (json.contains("minLevel") && json.contains("maxLevel")) {
+        double minLevel = json.value("minLevel").toDouble();
+        double maxLevel = json.value("maxLevel").toDouble();
+        params.windowCenter = (minLevel + maxLevel) / 2.0;
+        params.windowWidth = maxLevel - minLevel;
+    } else {
+        double fullRange = static_cast<double>(1 << std::clamp(params.bitDepth, 8, 16));
+        params.windowCenter = json.value("windowCenter").toDouble(fullRange / 2.0);
+        params.windowWidth = json.value("windowWidth").toDouble(fullRange);
+    }
+
+    params.gamma = json.value("gamma").toDouble(params.gamma);
+    if (params.gamma <= 0.0) {
+        params.gamma = 1.0;
+    }
+    params.invert = json.value("invert").toBool(params.invert);
+    params.colormap = colormapFromString(json.value("colormap").toString());
+    return params;
+}
+
+template <int BitDepth>
+DisplayPipeline::Lut DisplayPipeline::buildLut(const DisplayParams& params) {
+    constexpr int lutSize = 1 << BitDepth;
+    const Palette& palette = palettes[static_cast<int>(params.colormap)];
+
+    const double width = std::max(params.windowWidth, 1.0);
+    const double windowMin = params.windowCenter - width / 2.0;
+
+    Lut lut(lutSize);
+    for (int value = 0; value < lutSize; ++value) {
+        double t = std::clamp((value - windowMin) / width, 0.0, 1.0);
+        if (params.gamma != 1.0) {
+            t = std::pow(t, params.gamma);
+        }
+        if (params.invert) {
+            t = 1.0 - t;
+        }
+        lut[value] = palette[static_cast<int>(t * 255.0 + 0.5)];
+    }
+    return lut;
+}
+
+template <int BitDepth>
+void DisplayPipeline::applyLut(const cv::Mat& raw, const Lut& lut, cv::Mat& out) {
+    if constexpr (BitDepth == 8) {
+        // 8-bit input: one cv::LUT per output plane (SIMD-optimized in OpenCV) and a merge
+        cv::Mat planeLuts[3];
+        for (int plane = 0; plane < 3; ++plane) {
+            planeLuts[plane].create(1, 256, CV_8UC1);
+            uint8_t* entries = planeLuts[plane].ptr<uint8_t>();
+            for (int value = 0; value < 256; ++value) {
+                entries[value] = static_cast<uint8_t>(lut[value] >> (8 * plane));
+            }
+        }
+        cv::Mat planes[3];
+        for (int plane = 0; plane < 3; ++plane) {
+            cv::LUT(raw, planeLuts[plane], planes[plane]);
+        }
+        cv::merge(planes, 3, out);
+    } else {
+        // 10-16 bit input: scalar table lookup, split across rows with parallel_for_
+        constexpr uint32_t maxValue = (1u << BitDepth) - 1;
+        cv::parallel_for_(cv::Range(0, raw.rows), [&](const cv::Range& range) {
+            const uint32_t* table = lut.data();
+            for (int y = range.start; y < range.end; ++y) {
+                const uint16_t* src = raw.ptr<uint16_t>(y);
+                uint8_t* dst = out.ptr<uint8_t>(y);
+                for (int x = 0; x < raw.cols; ++x) {
+                    uint32_t color = table[std::min<uint32_t>(src[x], maxValue)];
+                    dst[3 * x] = static_cast<uint8_t>(color);
+                    dst[3 * x + 1] = static_cast<uint8_t>(color >> 8);
+                    dst[3 * x + 2] = static_cast<uint8_t>(color >> 16);
+                }
+            }
+        });
+    }
+}
+
+const DisplayPipeline::Lut& DisplayPipeline::lutFor(const DisplayParams& params) {
+    auto it = lutCache.find(params);
+    if (it != lutCache.end()) {
+        lutUsage.splice(lutUsage.begin(), lutUsage, it->second.usage);
+        return it->second.lut;
+    }
+
+    if (lutCache.size() >= maxCachedLuts) {
+        lutCache.erase(lutUsage.back());
+        lutUsage.pop_back();
+    }
+
+    Lut lut;
+    switch (params.bitDepth) {
+    case 8:  lut = buildLut<8>(params); break;
+    case 10: lut = buildLut<10>(params); break;
+    case 12: lut = buildLut<12>(params); break;
+    case 14: lut = buildLut<14>(params); break;
+    default: lut = buildLut<16>(params); break;
+    }
+
+    lutUsage.push_front(params);
+    return lutCache.emplace(params, CacheEntry{std::move(lut), lutUsage.begin()}).first->second.lut;
+}
+
+cv::Mat DisplayPipeline::render(const cv::Mat& raw, const DisplayParams& params) {
+    if (raw.empty()) {
+        return cv::Mat();
+    }
+
+    cv::Mat gray = raw;
+    if (raw.channels() == 3) {
+        cv::cvtColor(raw, gray, cv::COLOR_BGR2GRAY);
+    } else if (raw.channels() == 4) {
+        cv::cvtColor(raw, gray, cv::COLOR_BGRA2GRAY);
+    }
+
+    // The window is given in units of params.bitDepth; the data may have a
+    // different depth (e.g. 16-bit settings against an 8-bit frame), so the
+    // window is rescaled to the frame's actual depth instead of going black.
+    int dataBits;
+    DisplayParams effective = params;
+    if (gray.depth() == CV_8U) {
+        dataBits = 8;
+        effective.bitDepth = 8;
+    } else if (gray.depth() == CV_16U) {
+        dataBits = params.bitDepth > 8 ? params.bitDepth : 16;
+        effective.bitDepth = supportedBitDepth(dataBits);
+    } else {
+        qWarning() << "DisplayPipeline: unsupported frame depth" << gray.depth();
+        return cv::Mat();
+    }
+    if (dataBits != params.bitDepth) {
+        const double scale = std::ldexp(1.0, dataBits - params.bitDepth);
+        effective.windowCenter *= scale;
+        effective.windowWidth *= scale;
+    }
+
+    const Lut& lut = lutFor(effective);
+    cv::Mat out(gray.size(), CV_8UC3);
+    switch (effective.bitDepth) {
+    case 8:  applyLut<8>(gray, lut, out); break;
+    case 10: applyLut<10>(gray, lut, out); break;
+    case 12: applyLut<12>(gray, lut, out); break;
+    case 14: applyLut<14>(gray, lut, out); break;
+    default: applyLut<16>(gray, lut, out); break;
+    }
+    return out;
+}
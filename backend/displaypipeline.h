@@ -0,0 +1,63 @@
+#ifndef DISPLAYPIPELINE_H
+#define DISPLAYPIPELINE_H
+#include <QJsonObject>
+#include <QString>
+#include <opencv2/opencv.hpp>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <tuple>
+#include <vector>
+
+enum class Colormap { Gray, Hot, Jet, Bone };
+
+// Per-client display settings (same semantics as the JS transforms:
+// window in raw detector units, gamma as I_out = I_in^gamma)
+struct DisplayParams {
+    int bitDepth = 8;            // Units of the window (8-16); rescaled to the frame depth
+    double windowCenter = 128.0;
+    double windowWidth = 256.0;
+    double gamma = 1.0;
+    bool invert = false;
+    Colormap colormap = Colormap::Gray;
+
+    static DisplayParams fromJson(const QJsonObject& json);
+
+    bool operator<(const DisplayParams& other) const {
+        return std::tie(bitDepth, windowCenter, windowWidth, gamma, invert, colormap) <
+               std::tie(other.bitDepth, other.windowCenter, other.windowWidth, other.gamma, other.invert, other.colormap);
+    }
+};
+
+// Maps raw detector values to 8-bit BGR through a single lookup table.
+// The table is rebuilt only when the parameter set changes, so dragging
+// window/level costs one LUT rebuild instead of a full-image pass per step.
+class DisplayPipeline {
+public:
+    // raw: CV_8U/CV_16U single channel (3-channel input is converted to gray)
+    // returns CV_8UC3 BGR ready for JPEG encoding
+    cv::Mat render(const cv::Mat& raw, const DisplayParams& params);
+
+private:
+    // Packed 0x00RRGGBB entries, one per input value
+    using Lut = std::vector<uint32_t>;
+
+    template <int BitDepth>
+    static Lut buildLut(const DisplayParams& params);
+
+    template <int BitDepth>
+    static void applyLut(const cv::Mat& raw, const Lut& lut, cv::Mat& out);
+
+    const Lut& lutFor(const DisplayParams& params);
+
+    // Small LRU cache keyed by parameter set; each entry keeps its position
+    // in the usage list so a hit is an O(1) splice
+    struct CacheEntry {
+        Lut lut;
+        std::list<DisplayParams>::iterator usage;
+    };
+    static constexpr size_t maxCachedLuts = 8;
+    std::map<DisplayParams, CacheEntry> lutCache;
+    std::list<DisplayParams> lutUsage; // Most recently used first
+};
+#endif // DISPLAYPIPELINE_H
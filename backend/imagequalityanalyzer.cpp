@@ -0,0 +1,339 @@
+#include "imagequalityanalyzer.h"
+#include <QDateTime>
+#include <QDebug>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+cv::Rect2f rectFromJson(const QJsonValue& value, const cv::Rect2f& fallback) {
+    if (!value.isObject()) {
+        return fallback;
+    }
+    QJsonObject obj = value.toObject();
+    return cv::Rect2f(static_cast<float>(obj.value("x").toDouble(fallback.x)),
+                      static_cast<float>(obj.value("y").toDouble(fallback.y)),
+                      static_cast<float>(obj.value("width").toDouble(fallback.width)),
+                      static_cast<float>(obj.value("height").toDouble(fallback.height)));
+}
+
+double toDecibels(double ratio) {
+    return ratio > 0.0 ? 20.0 * std::log10(ratio) : 0.0;
+}
+
+const qint64 alertRepeatIntervalMs = 10000; // Same alert kind at most every 10 s
+
+} // namespace
+
+RollingStats::RollingStats(int capacity) {
+    setCapacity(capacity);
+}
+
+void RollingStats::setCapacity(int capacity) {
+    samples.assign(std::max(1, capacity), 0.0);
+    clear();
+}
+
+void RollingStats::clear() {
+    next = 0;
+    filled = 0;
+    runningMean = 0.0;
+    m2 = 0.0;
+}
+
+void RollingStats::add(double value) {
+    const int capacity = static_cast<int>(samples.size());
+    if (!isFull()) {
+        samples[next] = value;
+        next = (next + 1) % capacity;
+        ++filled;
+        double delta = value - runningMean;
+        runningMean += delta / filled;
+        m2 += delta * (value - runningMean);
+        return;
+    }
+
+    // Window full: replace the oldest sample in a single Welford step
+    double oldest = samples[next];
+    samples[next] = value;
+    next = (next + 1) % capacity;
+    double oldMean = runningMean;
+    runningMean += (value - oldest) / filled;
+    m2 += (value - oldest) * (value - runningMean + oldest - oldMean);
+    m2 = std::max(m2, 0.0); // Guard against rounding drift
+}
+
+QualityConfig QualityConfig::fromJson(const QJsonObject& json, const QualityConfig& base) {
+    QualityConfig cfg = base;
+    cfg.signalRoi = rectFromJson(json.value("signalRoi"), base.signalRoi);
+    cfg.backgroundRoi = rectFromJson(json.value("backgroundRoi"), base.backgroundRoi);
+    cfg.uniformityRoiSize = static_cast<float>(std::clamp(json.value("uniformityRoiSize").toDouble(base.uniformityRoiSize), 0.01, 0.5));
+    cfg.sampleIntervalMs = std::max(10, json.value("sampleIntervalMs").toInt(base.sampleIntervalMs));
+    cfg.cpuBudget = std::clamp(json.value("cpuBudget").toDouble(base.cpuBudget), 0.001, 1.0);
+    cfg.shortWindow = std::max(2, json.value("shortWindow").toInt(base.shortWindow));
+    cfg.longWindow = std::max(cfg.shortWindow * 2, json.value("longWindow").toInt(base.longWindow));
+    cfg.publishIntervalMs = std::max(100, json.value("publishIntervalMs").toInt(base.publishIntervalMs));
+    cfg.driftThresholdPercent = json.value("driftThresholdPercent").toDouble(base.driftThresholdPercent);
+    cfg.minSnrDb = json.value("minSnrDb").toDouble(base.minSnrDb);
+    cfg.minUniformityPercent = json.value("minUniformityPercent").toDouble(base.minUniformityPercent);
+    return cfg;
+}
+
+ImageQualityAnalyzer::ImageQualityAnalyzer(QObject* parent)
+    : QObject(parent), workerThread(nullptr) {
+    effectiveIntervalMs = config.sampleIntervalMs;
+}
+
+ImageQualityAnalyzer::~ImageQualityAnalyzer() {
+    stop();
+}
+
+void ImageQualityAnalyzer::start() {
+    if (running) {
+        return;
+    }
+    running = true;
+    workerThread = QThread::create([this]() { workerLoop(); });
+    workerThread->start(QThread::LowPriority);
+    qDebug() << "Image quality analyzer شروع شد";
+}
+
+void ImageQualityAnalyzer::stop() {
+    if (!workerThread) {
+        return;
+    }
+    {
+        QMutexLocker locker(&mutex);
+        running = false;
+        frameAvailable.wakeAll();
+    }
+    workerThread->wait();
+    delete workerThread;
+    workerThread = nullptr;
+}
+
+void ImageQualityAnalyzer::setConfig(const QualityConfig& newConfig) {
+    QMutexLocker locker(&mutex);
+    config = newConfig;
+    resetRequested = true;
+    effectiveIntervalMs = std::max(effectiveIntervalMs.load(), config.sampleIntervalMs);
+}
+
+QualityConfig ImageQualityAnalyzer::getConfig() {
+    QMutexLocker locker(&mutex);
+    return config;
+}
+
+void ImageQualityAnalyzer::submitFrame(const cv::Mat& frame, const QString& channel, bool simulated) {
+    if (!running || frame.empty()) {
+        return;
+    }
+
+    // Sampling gate checked before any copy so full-rate callers pay almost nothing
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (now - lastSubmitMs < effectiveIntervalMs) {
+        return;
+    }
+    lastSubmitMs = now;
+
+    QMutexLocker locker(&mutex);
+    frame.copyTo(pendingFrame);
+    pendingChannel = channel;
+    pendingSimulated = simulated;
+    hasPending = true;
+    frameAvailable.wakeOne();
+}
+
+void ImageQualityAnalyzer::workerLoop() {
+    cv::Mat frame;
+    QString channel;
+    bool simulated = false;
+
+    while (running) {
+        QualityConfig cfg;
+        bool reset = false;
+        {
+            QMutexLocker locker(&mutex);
+            while (running && !hasPending) {
+                frameAvailable.wait(&mutex, 200);
+            }
+            if (!running) {
+                break;
+            }
+            cv::swap(frame, pendingFrame);
+            channel = pendingChannel;
+            simulated = pendingSimulated;
+            hasPending = false;
+            cfg = config;
+            reset = resetRequested;
+            resetRequested = false;
+        }
+
+        // Drift windows must not mix simulated and detector samples
+        if (reset || simulated != analyzingSimulated) {
+            resetWindows(cfg);
+            analyzingSimulated = simulated;
+        }
+        analyze(frame, channel, simulated, cfg);
+    }
+}
+
+void ImageQualityAnalyzer::resetWindows(const QualityConfig& cfg) {
+    meanRecent.setCapacity(cfg.shortWindow);
+    gainRecent.setCapacity(cfg.shortWindow);
+    noiseRecent.setCapacity(cfg.shortWindow);
+    meanReference.setCapacity(cfg.longWindow);
+    gainReference.setCapacity(cfg.longWindow);
+    noiseReference.setCapacity(cfg.longWindow);
+    lastAlertTime.clear();
+}
+
+ImageQualityAnalyzer::RegionStats ImageQualityAnalyzer::regionStats(const cv::Mat& gray, const cv::Rect2f& roi) {
+    RegionStats stats;
+    cv::Rect rect(cvRound(roi.x * gray.cols), cvRound(roi.y * gray.rows),
+                  cvRound(roi.width * gray.cols), cvRound(roi.height * gray.rows));
+    rect &= cv::Rect(0, 0, gray.cols, gray.rows);
+    if (rect.area() == 0) {
+        return stats;
+    }
+
+    // Single-pass vectorized sum / sum of squares over the region
+    cv::Scalar mean, stddev;
+    cv::meanStdDev(gray(rect), mean, stddev);
+    stats.mean = mean[0];
+    stats.stddev = stddev[0];
+    return stats;
+}
+
+double ImageQualityAnalyzer::driftPercent(const RollingStats& recent, const RollingStats& reference) {
+    if (std::abs(reference.mean()) < 1e-9) {
+        return 0.0;
+    }
+    return (recent.mean() - reference.mean()) / reference.mean() * 100.0;
+}
+
+void ImageQualityAnalyzer::raiseAlert(const QString& kind, const QString& message, double value, double threshold, qint64 now) {
+    if (now - lastAlertTime.value(kind, 0) < alertRepeatIntervalMs) {
+        return;
+    }
+    lastAlertTime[kind] = now;
+
+    QJsonObject alert;
+    alert["kind"] = kind;
+    alert["message"] = message;
+    alert["value"] = value;
+    alert["threshold"] = threshold;
+    alert["timestamp"] = now;
+    emit alertRaised(alert);
+}
+
+void ImageQualityAnalyzer::analyze(const cv::Mat& frame, const QString& channel, bool simulated, const QualityConfig& cfg) {
+    QElapsedTimer analysisTimer;
+    analysisTimer.start();
+
+    cv::Mat gray = frame;
+    if (frame.channels() == 3) {
+        cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+    } else if (frame.channels() == 4) {
+        cv::cvtColor(frame, gray, cv::COLOR_BGRA2GRAY);
+    }
+
+    RegionStats signal = regionStats(gray, cfg.signalRoi);
+    RegionStats background = regionStats(gray, cfg.backgroundRoi);
+    double frameMean = cv::mean(gray)[0];
+
+    double contrast = std::abs(signal.mean - background.mean);
+    double pooledNoise = std::sqrt((signal.stddev * signal.stddev + background.stddev * background.stddev) / 2.0);
+    double snrDb = signal.stddev > 0.0 ? toDecibels(signal.mean / signal.stddev) : 0.0;
+    double cnrDb = pooledNoise > 0.0 ? toDecibels(contrast / pooledNoise) : 0.0;
+
+    // Uniformity over center and quadrant regions: 100 * (1 - (max - min) / (max + min))
+    const float size = cfg.uniformityRoiSize;
+    const float half = size / 2.0f;
+    const cv::Point2f centers[] = {{0.5f, 0.5f}, {0.25f, 0.25f}, {0.75f, 0.25f}, {0.25f, 0.75f}, {0.75f, 0.75f}};
+    double minMean = std::numeric_limits<double>::max();
+    double maxMean = std::numeric_limits<double>::lowest();
+    for (const cv::Point2f& center : centers) {
+        double mean = regionStats(gray, cv::Rect2f(center.x - half, center.y - half, size, size)).mean;
+        minMean = std::min(minMean, mean);
+        maxMean = std::max(maxMean, mean);
+    }
+    double uniformity = (maxMean + minMean) > 0.0 ? 100.0 * (1.0 - (maxMean - minMean) / (maxMean + minMean)) : 0.0;
+
+    // Long-term drift: recent window against the longer reference window
+    double gain = signal.mean - background.mean;
+    meanRecent.add(frameMean);
+    meanReference.add(frameMean);
+    gainRecent.add(gain);
+    gainReference.add(gain);
+    noiseRecent.add(signal.stddev);
+    noiseReference.add(signal.stddev);
+
+    bool driftReady = meanRecent.isFull() && meanReference.count() >= 2 * meanRecent.count();
+    double meanDrift = driftReady ? driftPercent(meanRecent, meanReference) : 0.0;
+    double gainDrift = driftReady ? driftPercent(gainRecent, gainReference) : 0.0;
+    double noiseDrift = driftReady ? driftPercent(noiseRecent, noiseReference) : 0.0;
+
+    // Alerts describe the detector; the simulated fallback would trip them constantly
+    qint64 now = QDateTime::currentMSecsSinceEpoch();
+    if (!simulated && snrDb < cfg.minSnrDb) {
+        raiseAlert("snr", "SNR below minimum", snrDb, cfg.minSnrDb, now);
+    }
+    if (!simulated && uniformity < cfg.minUniformityPercent) {
+        raiseAlert("uniformity", "Uniformity below minimum", uniformity, cfg.minUniformityPercent, now);
+    }
+    if (!simulated && driftReady) {
+        if (std::abs(meanDrift) > cfg.driftThresholdPercent) {
+            raiseAlert("meanDrift", "Mean level drift", meanDrift, cfg.driftThresholdPercent, now);
+        }
+        if (std::abs(gainDrift) > cfg.driftThresholdPercent) {
+            raiseAlert("gainDrift", "Gain drift", gainDrift, cfg.driftThresholdPercent, now);
+        }
+        if (std::abs(noiseDrift) > cfg.driftThresholdPercent) {
+            raiseAlert("noiseDrift", "Noise drift", noiseDrift, cfg.driftThresholdPercent, now);
+        }
+    }
+
+    // Adapt the sampling interval so analysis stays within the CPU budget
+    double analysisMs = analysisTimer.nsecsElapsed() / 1e6;
+    averageAnalysisMs = averageAnalysisMs == 0.0 ? analysisMs : 0.9 * averageAnalysisMs + 0.1 * analysisMs;
+    int budgetIntervalMs = static_cast<int>(std::ceil(averageAnalysisMs / cfg.cpuBudget));
+    effectiveIntervalMs = std::max(cfg.sampleIntervalMs, budgetIntervalMs);
+
+    if (now - lastPublishMs < cfg.publishIntervalMs) {
+        return;
+    }
+    lastPublishMs = now;
+
+    QJsonObject drift;
+    drift["ready"] = driftReady;
+    drift["mean"] = meanDrift;
+    drift["gain"] = gainDrift;
+    drift["noise"] = noiseDrift;
+
+    QJsonObject trend;
+    trend["mean"] = meanRecent.mean();
+    trend["meanStd"] = std::sqrt(meanRecent.variance());
+    trend["gain"] = gainRecent.mean();
+    trend["noise"] = noiseRecent.mean();
+    trend["samples"] = meanReference.count();
+
+    QJsonObject metrics;
+    metrics["channel"] = channel;
+    metrics["source"] = simulated ? "simulated" : "detector";
+    metrics["timestamp"] = now;
+    metrics["snr"] = snrDb;
+    metrics["cnr"] = cnrDb;
+    metrics["uniformity"] = uniformity;
+    metrics["signalMean"] = signal.mean;
+    metrics["signalStd"] = signal.stddev;
+    metrics["backgroundMean"] = background.mean;
+    metrics["frameMean"] = frameMean;
+    metrics["drift"] = drift;
+    metrics["trend"] = trend;
+    metrics["sampleIntervalMs"] = effectiveIntervalMs.load();
+    metrics["analysisMs"] = averageAnalysisMs;
+    emit metricsUpdated(metrics);
+}
@@ -0,0 +1,112 @@
+#ifndef IMAGEQUALITYANALYZER_H
+#define IMAGEQUALITYANALYZER_H
+#include <QObject>
+#include <QJsonObject>
+#include <QMap>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+#include <opencv2/opencv.hpp>
+#include <atomic>
+#include <vector>
+
+// Fixed-size rolling window with O(1) Welford updates (add, or replace oldest when full)
+class RollingStats {
+public:
+    explicit RollingStats(int capacity = 1);
+    void setCapacity(int capacity);
+    void add(double value);
+    void clear();
+    int count() const { return filled; }
+    bool isFull() const { return filled == static_cast<int>(samples.size()); }
+    double mean() const { return runningMean; }
+    double variance() const { return filled > 1 ? m2 / (filled - 1) : 0.0; }
+
+private:
+    std::vector<double> samples;
+    int next = 0;
+    int filled = 0;
+    double runningMean = 0.0;
+    double m2 = 0.0;
+};
+
+struct QualityConfig {
+    // Regions are normalized to the frame size so they survive resolution changes
+    cv::Rect2f signalRoi{0.40f, 0.40f, 0.20f, 0.20f};
+    cv::Rect2f backgroundRoi{0.05f, 0.75f, 0.15f, 0.15f};
+    float uniformityRoiSize = 0.10f;   // Center + four quadrant regions
+
+    int sampleIntervalMs = 200;        // Upper bound on analysis rate
+    double cpuBudget = 0.02;           // Fraction of one core the analyzer may use
+    int shortWindow = 30;              // Samples in the short (recent) drift window
+    int longWindow = 600;              // Samples in the long (reference) drift window
+    int publishIntervalMs = 1000;
+
+    double driftThresholdPercent = 2.0;
+    double minSnrDb = 20.0;
+    double minUniformityPercent = 90.0;
+
+    // Fields missing from json keep their value from base
+    static QualityConfig fromJson(const QJsonObject& json, const QualityConfig& base);
+};
+
+// Background analyzer for SNR, CNR, uniformity and long-term drift of
+// mean level, gain (signal - background) and noise. Frames are sampled at an
+// adaptive interval so analysis stays within cpuBudget at full frame rate.
+class ImageQualityAnalyzer : public QObject {
+    Q_OBJECT
+public:
+    explicit ImageQualityAnalyzer(QObject* parent = nullptr);
+    ~ImageQualityAnalyzer();
+
+    void start();
+    void stop();
+    void setConfig(const QualityConfig& newConfig);
+    QualityConfig getConfig();
+
+    // Cheap when no sample is due: the frame is only copied when it will be analyzed.
+    // Simulated frames are analyzed and reported (source "simulated") but never raise alerts
+    void submitFrame(const cv::Mat& frame, const QString& channel, bool simulated = false);
+
+signals:
+    void metricsUpdated(const QJsonObject& metrics);
+    void alertRaised(const QJsonObject& alert);
+
+private:
+    struct RegionStats {
+        double mean = 0.0;
+        double stddev = 0.0;
+    };
+
+    void workerLoop();
+    void analyze(const cv::Mat& frame, const QString& channel, bool simulated, const QualityConfig& cfg);
+    void resetWindows(const QualityConfig& cfg);
+    void raiseAlert(const QString& kind, const QString& message, double value, double threshold, qint64 now);
+    static RegionStats regionStats(const cv::Mat& gray, const cv::Rect2f& roi);
+    static double driftPercent(const RollingStats& recent, const RollingStats& reference);
+
+    QThread* workerThread;
+    std::atomic<bool> running{false};
+
+    QMutex mutex;
+    QWaitCondition frameAvailable;
+    cv::Mat pendingFrame;
+    QString pendingChannel;
+    bool pendingSimulated = false;
+    bool hasPending = false;
+    bool resetRequested = true;
+    QualityConfig config;
+
+    std::atomic<qint64> lastSubmitMs{0};
+    std::atomic<int> effectiveIntervalMs{200};
+
+    // Worker-thread state
+    RollingStats meanRecent, meanReference;
+    RollingStats gainRecent, gainReference;
+    RollingStats noiseRecent, noiseReference;
+    QMap<QString, qint64> lastAlertTime;
+    bool analyzingSimulated = false;
+    qint64 lastPublishMs = 0;
+    double averageAnalysisMs = 0.0;
+};
+#endif // IMAGEQUALITYANALYZER_H
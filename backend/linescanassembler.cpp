@@ -0,0 +1,115 @@
+#include "linescanassembler.h"
+#include <QDebug>
+#include <algorithm>
+
+LineScanAssembler::LineScanAssembler(int lineWidth, int chunkRows, size_t memoryBudgetBytes, size_t preallocatedBytes)
+    : width(std::max(1, lineWidth)), chunkRows(std::max(1, chunkRows)) {
+    // Chunk counts derive from bytes so wide detectors don't exceed the budget
+    const size_t chunkBytes = static_cast<size_t>(this->chunkRows) * width * sizeof(uint16_t);
+    maxChunks = static_cast<int>(std::clamp<size_t>(memoryBudgetBytes / chunkBytes, 2, 1 << 16));
+    preallocatedChunks = static_cast<int>(std::clamp<size_t>(preallocatedBytes / chunkBytes, 1, maxChunks));
+
+    chunks.reserve(maxChunks);
+    for (int i = 0; i < preallocatedChunks; ++i) {
+        chunks.emplace_back(this->chunkRows, width, CV_16UC1);
+    }
+    correctionBuffer.create(this->chunkRows, width, CV_32FC1);
+}
+
+void LineScanAssembler::setCorrection(const cv::Mat& darkLine, const cv::Mat& gainLine) {
+    darkBlock.release();
+    gainBlock.release();
+    if (darkLine.empty() || gainLine.empty()) {
+        return;
+    }
+    if (darkLine.cols != width || gainLine.cols != width) {
+        qWarning() << "LineScanAssembler: correction width mismatch" << darkLine.cols << gainLine.cols << width;
+        return;
+    }
+
+    cv::Mat dark, gain;
+    darkLine.reshape(1, 1).convertTo(dark, CV_32F);
+    gainLine.reshape(1, 1).convertTo(gain, CV_32F);
+    cv::repeat(dark, chunkRows, 1, darkBlock);
+    cv::repeat(gain, chunkRows, 1, gainBlock);
+}
+
+void LineScanAssembler::correctLines(const cv::Mat& src, cv::Mat& dst) {
+    if (darkBlock.empty()) {
+        src.copyTo(dst);
+        return;
+    }
+
+    // Whole-block OpenCV arithmetic (SIMD-vectorized) instead of per-line loops
+    const int n = src.rows;
+    cv::Mat scratch = correctionBuffer.rowRange(0, n);
+    src.convertTo(scratch, CV_32F);
+    cv::subtract(scratch, darkBlock.rowRange(0, n), scratch);
+    cv::multiply(scratch, gainBlock.rowRange(0, n), scratch);
+    scratch.convertTo(dst, CV_16U); // saturate_cast clamps to [0, 65535]
+}
+
+int LineScanAssembler::append(const cv::Mat& lines) {
+    if (lines.empty()) {
+        return 0;
+    }
+    if (lines.cols != width || lines.type() != CV_16UC1) {
+        qWarning() << "LineScanAssembler: unexpected line format" << lines.cols << lines.type();
+        return 0;
+    }
+
+    int appended = 0;
+    while (appended < lines.rows) {
+        int slot = chunkSlot(totalRows);
+        int chunkOffset = static_cast<int>(totalRows % chunkRows);
+        if (slot >= static_cast<int>(chunks.size())) {
+            chunks.emplace_back(chunkRows, width, CV_16UC1);
+        }
+
+        // Once every slot is in use the oldest chunk is overwritten (ring rollover)
+        int count = std::min(lines.rows - appended, chunkRows - chunkOffset);
+        cv::Mat dst = chunks[slot].rowRange(chunkOffset, chunkOffset + count);
+        correctLines(lines.rowRange(appended, appended + count), dst);
+
+        appended += count;
+        totalRows += count;
+    }
+    return appended;
+}
+
+int64_t LineScanAssembler::firstRow() const {
+    if (totalRows == 0) {
+        return 0;
+    }
+    // The chunk being written shares its slot with the one maxChunks before it
+    int64_t currentChunk = (totalRows - 1) / chunkRows;
+    return std::max<int64_t>(0, (currentChunk - maxChunks + 1) * chunkRows);
+}
+
+cv::Mat LineScanAssembler::rows(int64_t startRow, int64_t endRow) const {
+    startRow = std::clamp(startRow, firstRow(), totalRows);
+    endRow = std::clamp(endRow, startRow, totalRows);
+    if (startRow == endRow) {
+        return cv::Mat();
+    }
+
+    cv::Mat strip(static_cast<int>(endRow - startRow), width, CV_16UC1);
+    int64_t row = startRow;
+    while (row < endRow) {
+        int chunkOffset = static_cast<int>(row % chunkRows);
+        int count = static_cast<int>(std::min<int64_t>(endRow - row, chunkRows - chunkOffset));
+        int stripRow = static_cast<int>(row - startRow);
+        chunks[chunkSlot(row)].rowRange(chunkOffset, chunkOffset + count)
+            .copyTo(strip.rowRange(stripRow, stripRow + count));
+        row += count;
+    }
+    return strip;
+}
+
+void LineScanAssembler::reset() {
+    // Keep the preallocated chunks for the next acquisition, release the rest
+    totalRows = 0;
+    if (static_cast<int>(chunks.size()) > preallocatedChunks) {
+        chunks.resize(preallocatedChunks);
+    }
+}
@@ -0,0 +1,53 @@
+#ifndef LINESCANASSEMBLER_H
+#define LINESCANASSEMBLER_H
+#include <opencv2/opencv.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Appends detector lines into a growing strip image.
+// Storage is a ring of fixed-size row chunks sized from a byte budget:
+// appending never moves rows that are already stored, and once the budget is
+// reached the oldest chunk is reused, so a long scan rolls over instead of ending.
+// Row indices are absolute (counted since reset()); rows older than firstRow()
+// have been overwritten.
+// Optional per-pixel line correction: out = (raw - dark) * gain, saturated to 16 bit.
+class LineScanAssembler {
+public:
+    explicit LineScanAssembler(int lineWidth, int chunkRows = 1024,
+                               size_t memoryBudgetBytes = 256u << 20,
+                               size_t preallocatedBytes = 32u << 20);
+
+    // dark/gain: 1 x lineWidth CV_32FC1; empty Mats disable correction
+    void setCorrection(const cv::Mat& darkLine, const cv::Mat& gainLine);
+
+    // lines: N x lineWidth CV_16UC1. Returns rows stored
+    int append(const cv::Mat& lines);
+
+    // Contiguous copy of rows [startRow, endRow), clamped to the retained range
+    cv::Mat rows(int64_t startRow, int64_t endRow) const;
+
+    // Starts a new strip and frees chunks above the preallocation
+    void reset();
+    int64_t rowCount() const { return totalRows; }
+    int64_t firstRow() const;
+    int lineWidth() const { return width; }
+    int capacity() const { return chunkRows * maxChunks; }
+
+private:
+    void correctLines(const cv::Mat& src, cv::Mat& dst);
+    int chunkSlot(int64_t row) const { return static_cast<int>((row / chunkRows) % maxChunks); }
+
+    int width;
+    int chunkRows;
+    int maxChunks;
+    int preallocatedChunks;
+    int64_t totalRows = 0;
+    std::vector<cv::Mat> chunks;
+
+    // Correction lines broadcast to chunkRows so a whole block is one vectorized op
+    cv::Mat darkBlock;
+    cv::Mat gainBlock;
+    cv::Mat correctionBuffer;
+};
+#endif // LINESCANASSEMBLER_H
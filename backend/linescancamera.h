@@ -0,0 +1,27 @@
+#ifndef LINESCANCAMERA_H
+#define LINESCANCAMERA_H
+#include <QObject>
+#include <opencv2/opencv.hpp>
+
+// Line-scan source (linear detector). Unlike Camera it delivers a stream of
+// single detector lines; grabLines() drains everything acquired since the last call.
+class LineScanCamera : public QObject {
+    Q_OBJECT
+public:
+    explicit LineScanCamera(QObject* parent = nullptr) : QObject(parent) {}
+    virtual ~LineScanCamera() {}
+    virtual bool isConnected() const = 0;
+    virtual int lineWidth() const = 0;
+    // Fills `lines` with N x lineWidth() CV_16UC1 rows, returns N (0 if none pending)
+    virtual int grabLines(cv::Mat& lines) = 0;
+    virtual QString getChannel() const = 0;
+    // Lines lost because the consumer fell behind (0 if the source cannot tell)
+    virtual qint64 getDroppedLines() const { return 0; }
+    // Generated data rather than a physical detector
+    virtual bool isSimulated() const { return false; }
+
+public slots:
+    virtual void startAcquisition() = 0;
+    virtual void stopAcquisition() = 0;
+};
+#endif // LINESCANCAMERA_H
@@ -0,0 +1,62 @@
+#include "localframeserver.h"
+#include <QWebEngineUrlScheme>
+#include <QWebEngineUrlRequestJob>
+#include <QBuffer>
+#include <QUrl>
+#include <QDebug>
+
+const QByteArray LocalFrameServer::schemeName = "ct2frame";
+
+void LocalFrameServer::registerScheme() {
+    QWebEngineUrlScheme scheme(schemeName);
+    scheme.setSyntax(QWebEngineUrlScheme::Syntax::Path);
+    // Local page is loaded from file://, so the scheme must be reachable from it
+    // and usable with fetch() to keep canvases untainted for getImageData().
+    // Before Qt 6.6 fetch() is refused and the page stays on the WebSocket path
+    QWebEngineUrlScheme::Flags flags = QWebEngineUrlScheme::LocalScheme |
+                                       QWebEngineUrlScheme::LocalAccessAllowed |
+                                       QWebEngineUrlScheme::CorsEnabled;
+#if QT_VERSION >= QT_VERSION_CHECK(6, 6, 0)
+    flags |= QWebEngineUrlScheme::FetchApiAllowed;
+#endif
+    scheme.setFlags(flags);
+    QWebEngineUrlScheme::registerScheme(scheme);
+}
+
+LocalFrameServer::LocalFrameServer(QObject* parent)
+    : QWebEngineUrlSchemeHandler(parent) {
+}
+
+void LocalFrameServer::requestStarted(QWebEngineUrlRequestJob* job) {
+    // ct2frame:<channel>?seq=N - the query only defeats caching
+    QString path = job->requestUrl().path();
+    QString channel = path.section('/', -1);
+
+    auto it = latestFrames.constFind(channel);
+    if (it == latestFrames.constEnd() || it->isEmpty()) {
+        job->fail(QWebEngineUrlRequestJob::UrlNotFound);
+        return;
+    }
+
+#if QT_VERSION >= QT_VERSION_CHECK(6, 6, 0)
+    QMultiMap<QByteArray, QByteArray> headers;
+    headers.insert("Access-Control-Allow-Origin", "*");
+    headers.insert("Cache-Control", "no-store");
+    job->setAdditionalResponseHeaders(headers);
+#endif
+
+    // QBuffer shares the cached QByteArray - no copy of the JPEG data
+    QBuffer* buffer = new QBuffer(job);
+    buffer->setData(*it);
+    buffer->open(QIODevice::ReadOnly);
+    job->reply("image/jpeg", buffer);
+}
+
+void LocalFrameServer::publishFrame(const QString& channel, const QByteArray& encodedData) {
+    if (encodedData.isEmpty()) {
+        return;
+    }
+    latestFrames[channel] = encodedData;
+    int sequence = ++sequences[channel];
+    emit frameReady(channel, sequence);
+}
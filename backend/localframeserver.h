@@ -0,0 +1,35 @@
+#ifndef LOCALFRAMESERVER_H
+#define LOCALFRAMESERVER_H
+#include <QWebEngineUrlSchemeHandler>
+#include <QByteArray>
+#include <QMap>
+
+class QWebEngineUrlRequestJob;
+
+// In-process frame path for the embedded QWebEngineView.
+// Serves the latest encoded frame per channel under ct2frame:<channel>
+// and announces new frames over QWebChannel, so the local view skips the
+// loopback WebSocket and base64 round trip. Remote clients keep using WebSocket.
+class LocalFrameServer : public QWebEngineUrlSchemeHandler {
+    Q_OBJECT
+public:
+    static const QByteArray schemeName;
+
+    // Must be called before QApplication is constructed
+    static void registerScheme();
+
+    explicit LocalFrameServer(QObject* parent = nullptr);
+
+    void requestStarted(QWebEngineUrlRequestJob* job) override;
+
+    // Stores the encoded frame by reference (QByteArray is implicitly shared)
+    void publishFrame(const QString& channel, const QByteArray& encodedData);
+
+signals:
+    void frameReady(const QString& channel, int sequence);
+
+private:
+    QMap<QString, QByteArray> latestFrames;
+    QMap<QString, int> sequences;
+};
+#endif // LOCALFRAMESERVER_H
@@ -3,9 +3,11 @@
 #include <QDir>
 #include <QUrl>
 #include "backend.h"
+#include "localframeserver.h"
 
 int main(int argc, char *argv[])
 {
+    LocalFrameServer::registerScheme(); // Custom schemes must be registered before QApplication
     QApplication app(argc, argv);
 
     QWebEngineView view;
@@ -0,0 +1,153 @@
+#include "syntheticlinecamera.h"
+#include <QDebug>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+
+SyntheticLineCamera::SyntheticLineCamera(int width, double lineRate, QObject* parent, size_t pendingBudgetBytes)
+    : LineScanCamera(parent), width(std::max(1, width)), lineRate(std::max(1.0, lineRate)),
+      workerThread(nullptr) {
+    // Half a second of buffering before lines are dropped, capped by the byte budget
+    // so wide, fast configurations don't allocate gigabytes up front
+    const size_t lineBytes = static_cast<size_t>(this->width) * sizeof(uint16_t);
+    const int budgetLines = static_cast<int>(std::clamp<size_t>(pendingBudgetBytes / lineBytes, 1, 1 << 20));
+    maxPendingLines = std::clamp(static_cast<int>(this->lineRate / 2.0), 1, budgetLines);
+    pendingLines.resize(static_cast<size_t>(maxPendingLines) * this->width);
+
+    // Fixed-pattern detector response (dark offset and pixel gain non-uniformity)
+    std::mt19937 rng(12345);
+    std::normal_distribution<float> darkDist(1000.0f, 40.0f);
+    std::normal_distribution<float> gainDist(1.0f, 0.05f);
+    std::uniform_int_distribution<int> noiseDist(0, 400);
+
+    darkOffset.resize(this->width);
+    pixelGain.resize(this->width);
+    for (int x = 0; x < this->width; ++x) {
+        darkOffset[x] = darkDist(rng);
+        pixelGain[x] = std::clamp(gainDist(rng), 0.8f, 1.2f);
+    }
+
+    noiseTable.resize(65536);
+    for (uint16_t& value : noiseTable) {
+        value = static_cast<uint16_t>(noiseDist(rng));
+    }
+}
+
+SyntheticLineCamera::~SyntheticLineCamera() {
+    stopAcquisition();
+    qDebug() << "Synthetic line camera آزاد شد";
+}
+
+bool SyntheticLineCamera::isConnected() const {
+    return running;
+}
+
+void SyntheticLineCamera::startAcquisition() {
+    if (running) {
+        return;
+    }
+    {
+        QMutexLocker locker(&pendingMutex);
+        pendingCount = 0;
+    }
+    droppedLines = 0;
+    running = true;
+    workerThread = QThread::create([this]() { acquisitionLoop(); });
+    workerThread->start();
+    qDebug() << "Synthetic line scan شروع شد:" << width << "px @" << lineRate << "Hz";
+}
+
+void SyntheticLineCamera::stopAcquisition() {
+    running = false;
+    if (workerThread) {
+        workerThread->wait();
+        delete workerThread;
+        workerThread = nullptr;
+    }
+}
+
+int SyntheticLineCamera::grabLines(cv::Mat& lines) {
+    QMutexLocker locker(&pendingMutex);
+    if (pendingCount == 0) {
+        return 0;
+    }
+    lines.create(pendingCount, width, CV_16UC1);
+    std::memcpy(lines.data, pendingLines.data(), static_cast<size_t>(pendingCount) * width * sizeof(uint16_t));
+    int count = pendingCount;
+    pendingCount = 0;
+    return count;
+}
+
+cv::Mat SyntheticLineCamera::darkLine() const {
+    return cv::Mat(1, width, CV_32FC1, const_cast<float*>(darkOffset.data())).clone();
+}
+
+cv::Mat SyntheticLineCamera::gainLine() const {
+    // Correction gain is the inverse of the simulated pixel response
+    cv::Mat gain(1, width, CV_32FC1);
+    for (int x = 0; x < width; ++x) {
+        gain.at<float>(0, x) = 1.0f / pixelGain[x];
+    }
+    return gain;
+}
+
+void SyntheticLineCamera::generateLine(uint16_t* dst, qint64 lineIndex) const {
+    // Slowly varying transmission plus an absorbing disc passing through the beam
+    const float lineFactor = 0.75f + 0.2f * std::sin(lineIndex * 0.0005f);
+    const int period = 4000;
+    const int radius = width / 4;
+    const int dy = static_cast<int>(lineIndex % period) - period / 2;
+    int chord = 0;
+    if (std::abs(dy) < radius) {
+        chord = static_cast<int>(std::sqrt(static_cast<double>(radius) * radius - static_cast<double>(dy) * dy));
+    }
+    const int discStart = width / 2 - chord;
+    const int discEnd = width / 2 + chord;
+    const size_t noiseOffset = static_cast<size_t>(lineIndex * 7919) & 0xFFFF;
+
+    for (int x = 0; x < width; ++x) {
+        float signal = 40000.0f * lineFactor;
+        if (x >= discStart && x < discEnd) {
+            signal *= 0.35f;
+        }
+        float value = darkOffset[x] + pixelGain[x] * signal + noiseTable[(noiseOffset + x) & 0xFFFF];
+        dst[x] = static_cast<uint16_t>(std::min(value, 65535.0f));
+    }
+}
+
+void SyntheticLineCamera::acquisitionLoop() {
+    QElapsedTimer clock;
+    clock.start();
+    qint64 generatedLines = 0;
+    std::vector<uint16_t> batch;
+
+    while (running) {
+        qint64 dueLines = static_cast<qint64>(clock.nsecsElapsed() * 1e-9 * lineRate);
+        qint64 behind = dueLines - generatedLines;
+        if (behind <= 0) {
+            QThread::usleep(200);
+            continue;
+        }
+        // After a stall, skip what cannot be buffered anyway
+        int count = static_cast<int>(std::min<qint64>(behind, maxPendingLines));
+        droppedLines += behind - count;
+        generatedLines = dueLines - count;
+
+        batch.resize(static_cast<size_t>(count) * width);
+        for (int i = 0; i < count; ++i) {
+            generateLine(batch.data() + static_cast<size_t>(i) * width, generatedLines + i);
+        }
+
+        {
+            QMutexLocker locker(&pendingMutex);
+            int accepted = std::min(count, maxPendingLines - pendingCount);
+            std::memcpy(pendingLines.data() + static_cast<size_t>(pendingCount) * width, batch.data(),
+                        static_cast<size_t>(accepted) * width * sizeof(uint16_t));
+            pendingCount += accepted;
+            droppedLines += count - accepted;
+        }
+        generatedLines = dueLines;
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef SYNTHETICLINECAMERA_H
+#define SYNTHETICLINECAMERA_H
+#include "linescancamera.h"
+#include <QThread>
+#include <QMutex>
+#include <atomic>
+#include <vector>
+#include <cstddef>
+#include <cstdint>
+
+// Synthetic linear detector for exercising the line-scan path at tens of kHz.
+// Lines carry fixed-pattern dark offset/gain so line correction has work to do.
+class SyntheticLineCamera : public LineScanCamera {
+    Q_OBJECT
+public:
+    explicit SyntheticLineCamera(int width = 1024, double lineRate = 20000.0, QObject* parent = nullptr,
+                                 size_t pendingBudgetBytes = 16u << 20);
+    ~SyntheticLineCamera();
+    bool isConnected() const override;
+    int lineWidth() const override { return width; }
+    int grabLines(cv::Mat& lines) override;
+    QString getChannel() const override { return "linescan"; }
+    qint64 getDroppedLines() const override { return droppedLines; }
+    bool isSimulated() const override { return true; }
+
+    double getLineRate() const { return lineRate; }
+
+    // Fixed-pattern reference lines matching the generator (CV_32FC1, 1 x width)
+    cv::Mat darkLine() const;
+    cv::Mat gainLine() const;
+
+public slots:
+    void startAcquisition() override;
+    void stopAcquisition() override;
+
+private:
+    void acquisitionLoop();
+    void generateLine(uint16_t* dst, qint64 lineIndex) const;
+
+    int width;
+    double lineRate;
+    QThread* workerThread;
+    std::atomic<bool> running{false};
+
+    QMutex pendingMutex;
+    std::vector<uint16_t> pendingLines; // Row-major, preallocated for maxPendingLines (within the byte budget)
+    int pendingCount = 0;
+    int maxPendingLines;
+    std::atomic<qint64> droppedLines{0};
+
+    std::vector<float> darkOffset;
+    std::vector<float> pixelGain;
+    std::vector<uint16_t> noiseTable;
+};
+#endif // SYNTHETICLINECAMERA_H
@@ -1,9 +1,11 @@
 import React, { useState, useEffect } from 'react';
 import { useTranslation } from 'react-i18next';
 import { Activity, TrendingUp, AlertTriangle, CheckCircle } from 'lucide-react';
+import { useWebSocket } from '../contexts/WebSocketContext';
 
 const ImageQualityAssessment = ({ disabled = false }) => {
   const { t } = useTranslation();
+  const { addMessageCallback } = useWebSocket();
 
   // پارامترهای کیفیت تصویر
   const [qualityMetrics, setQualityMetrics] = useState({
@@ -22,23 +24,35 @@ const ImageQualityAssessment = ({ disabled = false }) => {
     assessmentCount: 0
   });
 
-  // شبیه‌سازی ارزیابی کیفیت
+  // منبع متریک‌ها: 'detector' یا 'simulated' (فریم جایگزین وقتی آشکارساز وصل نیست)
+  const [source, setSource] = useState(null);
+
+  // دریافت متریک‌های کیفیت از backend (quality:{json})
   useEffect(() => {
-    if (assessmentStatus.isAssessing) {
-      const interval = setInterval(() => {
-        setQualityMetrics({
-          snr: 25 + Math.random() * 15, // 25-40 dB
-          cnr: 15 + Math.random() * 10, // 15-25 dB
-          spatialResolution: 8 + Math.random() * 4, // 8-12 lp/mm
-          uniformity: 90 + Math.random() * 8, // 90-98%
-          artifacts: Math.floor(Math.random() * 5), // 0-4
-          overallQuality: 75 + Math.random() * 20 // 75-95
-        });
-      }, 1000);
+    if (!assessmentStatus.isAssessing) return;
 
-      return () => clearInterval(interval);
-    }
-  }, [assessmentStatus.isAssessing]);
+    const handleQualityMessage = (message) => {
+      if (typeof message !== 'string' || !message.startsWith('quality:')) return;
+      try {
+        const report = JSON.parse(message.slice(8));
+        // Overall score: average of SNR/CNR/uniformity relative to their "excellent" thresholds
+        const score = (Math.min(1, report.snr / 35) + Math.min(1, report.cnr / 20) +
+          Math.min(1, report.uniformity / 95)) / 3 * 100;
+        setQualityMetrics(prev => ({
+          ...prev,
+          snr: report.snr,
+          cnr: report.cnr,
+          uniformity: report.uniformity,
+          overallQuality: Math.max(0, score)
+        }));
+        setSource(report.source ?? null);
+      } catch (error) {
+        console.error('❌ Invalid quality report:', error);
+      }
+    };
+
+    return addMessageCallback(handleQualityMessage);
+  }, [assessmentStatus.isAssessing, addMessageCallback]);
 
   // شروع ارزیابی
   const startAssessment = () => {
@@ -179,6 +193,11 @@ const ImageQualityAssessment = ({ disabled = false }) => {
               <div>
                 <div className="text-sm text-text-muted mb-1">
                   {t('overallQuality') || 'Overall Quality'}
+                  {source === 'simulated' && (
+                    <span className="ml-2 text-xs font-semibold text-yellow-600 dark:text-yellow-400">
+                      ({t('simulated') || 'Simulated'})
+                    </span>
+                  )}
                 </div>
                 <div className={`text-3xl font-bold ${overallStatus.color}`}>
                   {qualityMetrics.overallQuality.toFixed(1)}%
@@ -1,9 +1,17 @@
-import React, { useState, useMemo } from 'react';
+import React, { useState, useMemo, useEffect, useRef } from 'react';
 import { useTranslation } from 'react-i18next';
 import { Maximize2, Play, Pause, RotateCcw } from 'lucide-react';
+import { useWebSocket } from '../contexts/WebSocketContext';
+
+// ارتفاع نوار نمایش (ردیف)؛ ردیف‌های قدیمی‌تر به بالا اسکرول میشن
+const STRIP_HEIGHT = 512;
 
 const LinearDetectorImaging = ({ disabled = false }) => {
   const { t } = useTranslation();
+  const { send, addMessageCallback } = useWebSocket();
+  const canvasRef = useRef(null);
+  const drawQueueRef = useRef(Promise.resolve());
+  const isScanningRef = useRef(false);
 
   // تنظیمات
   const [settings, setSettings] = useState({
@@ -11,17 +19,96 @@ const LinearDetectorImaging = ({ disabled = false }) => {
     scanHeight: 500, // mm
     verticalStepSize: 10, // mm
     stitchingOverlap: 5, // %
-    detectorHeight: 50 // mm
+    detectorHeight: 50, // mm
+    lineWidth: 1024, // px
+    lineRate: 20000 // Hz
   });
 
-  // وضعیت اسکن
+  // وضعیت اسکن (از backend: linescanStatus:{json} و linescan:<startRow>:<jpeg>)
   const [scanStatus, setScanStatus] = useState({
     isScanning: false,
-    currentStep: 0,
-    totalSteps: 0,
-    progress: 0
+    rows: 0,
+    source: null, // 'detector' | 'simulated'
+    droppedLines: 0
   });
 
+  useEffect(() => {
+    isScanningRef.current = scanStatus.isScanning;
+  }, [scanStatus.isScanning]);
+
+  const clearStrip = () => {
+    const canvas = canvasRef.current;
+    if (canvas) {
+      canvas.getContext('2d').clearRect(0, 0, canvas.width, canvas.height);
+    }
+  };
+
+  // ردیف‌های جدید پایین نوار رسم میشن و محتوای قبلی به بالا شیفت می‌خوره
+  const drawStripRows = (image) => {
+    const canvas = canvasRef.current;
+    if (!canvas) return;
+    if (canvas.width !== image.width || canvas.height !== STRIP_HEIGHT) {
+      canvas.width = image.width;
+      canvas.height = STRIP_HEIGHT;
+    }
+    const ctx = canvas.getContext('2d');
+    const count = Math.min(image.height, canvas.height);
+    if (count < canvas.height) {
+      ctx.drawImage(canvas, 0, count, canvas.width, canvas.height - count, 0, 0, canvas.width, canvas.height - count);
+    }
+    ctx.drawImage(image, 0, image.height - count, image.width, count, 0, canvas.height - count, canvas.width, count);
+  };
+
+  // JPEG ها async دیکد میشن؛ صف باعث میشه به ترتیب رسیدن رسم بشن
+  const appendRows = (startRow, base64Data) => {
+    drawQueueRef.current = drawQueueRef.current.then(() => new Promise((resolve) => {
+      const image = new Image();
+      image.onload = () => {
+        drawStripRows(image);
+        setScanStatus(prev => ({ ...prev, rows: startRow + image.height }));
+        resolve();
+      };
+      image.onerror = () => resolve();
+      image.src = `data:image/jpeg;base64,${base64Data}`;
+    }));
+  };
+
+  useEffect(() => {
+    const handleLineScanMessage = (message) => {
+      if (typeof message !== 'string') return;
+      try {
+        if (message.startsWith('linescanStatus:')) {
+          const status = JSON.parse(message.slice(15));
+          if (status.state === 'started') clearStrip();
+          setScanStatus(prev => ({
+            ...prev,
+            isScanning: status.state === 'started',
+            rows: status.rows,
+            source: status.source,
+            droppedLines: status.droppedLines
+          }));
+        } else if (message.startsWith('linescan:')) {
+          const separatorIndex = message.indexOf(':', 9);
+          if (separatorIndex === -1) return;
+          appendRows(parseInt(message.slice(9, separatorIndex), 10), message.slice(separatorIndex + 1));
+        }
+      } catch (error) {
+        console.error('❌ Invalid line scan message:', error);
+      }
+    };
+
+    return addMessageCallback(handleLineScanMessage);
+  }, [addMessageCallback]);
+
+  // اسکن در حال اجرا با بسته شدن صفحه متوقف میشه
+  useEffect(() => {
+    return () => {
+      if (isScanningRef.current) {
+        send('LineScan:' + JSON.stringify({ action: 'stop' }));
+      }
+    };
+  }, [send]);
+
   // تغییر پارامتر
   const handleParamChange = (param, value) => {
     setSettings({
@@ -52,48 +139,31 @@ const LinearDetectorImaging = ({ disabled = false }) => {
 
   // شروع اسکن
   const startScan = () => {
-    const totalSteps = calculateSteps;
-    setScanStatus({
-      isScanning: true,
-      currentStep: 0,
-      totalSteps,
-      progress: 0
-    });
-
-    // شبیه‌سازی اسکن
-    let currentStep = 0;
-    const interval = setInterval(() => {
-      currentStep++;
-      const progress = (currentStep / totalSteps) * 100;
-
-      setScanStatus({
-        isScanning: currentStep < totalSteps,
-        currentStep,
-        totalSteps,
-        progress: Math.min(progress, 100)
-      });
-
-      if (currentStep >= totalSteps) {
-        clearInterval(interval);
-      }
-    }, 100);
+    const started = send('LineScan:' + JSON.stringify({
+      action: 'start',
+      width: settings.lineWidth,
+      lineRate: settings.lineRate,
+      correction: true
+    }));
+    if (started) {
+      setScanStatus(prev => ({ ...prev, isScanning: true, rows: 0, droppedLines: 0 }));
+    }
   };
 
   // توقف اسکن
   const stopScan = () => {
-    setScanStatus({
-      ...scanStatus,
-      isScanning: false
-    });
+    send('LineScan:' + JSON.stringify({ action: 'stop' }));
+    setScanStatus(prev => ({ ...prev, isScanning: false }));
   };
 
   // ریست
   const resetScan = () => {
+    clearStrip();
     setScanStatus({
       isScanning: false,
-      currentStep: 0,
-      totalSteps: 0,
-      progress: 0
+      rows: 0,
+      source: null,
+      droppedLines: 0
     });
   };
 
@@ -123,26 +193,31 @@ const LinearDetectorImaging = ({ disabled = false }) => {
 
       {settings.enabled && (
         <>
-          {/* Progress Bar */}
-          {scanStatus.progress > 0 && (
+          {/* Strip */}
+          {(scanStatus.isScanning || scanStatus.rows > 0) && (
             <div className="space-y-2">
               <div className="flex items-center justify-between text-sm">
                 <span className="text-text-muted">
                   {scanStatus.isScanning ? t('acquiring') || 'Scanning...' : t('completed') || 'Completed'}
+                  {scanStatus.source === 'simulated' && (
+                    <span className="ml-2 text-xs font-semibold text-yellow-600 dark:text-yellow-400">
+                      ({t('simulated') || 'Simulated'})
+                    </span>
+                  )}
                 </span>
                 <span className="font-mono font-bold text-primary">
-                  {scanStatus.progress.toFixed(1)}%
+                  {scanStatus.rows} rows
                 </span>
               </div>
-              <div className="h-3 bg-gray-200 dark:bg-gray-700 rounded-full overflow-hidden">
-                <div
-                  className="h-full bg-gradient-to-r from-green-500 to-blue-500 transition-all duration-300"
-                  style={{ width: `${scanStatus.progress}%` }}
-                ></div>
-              </div>
-              <div className="text-xs text-text-muted text-center">
-                Step: {scanStatus.currentStep} / {scanStatus.totalSteps}
-              </div>
+              <canvas
+                ref={canvasRef}
+                className="w-full h-64 rounded-lg bg-black"
+              />
+              {scanStatus.droppedLines > 0 && (
+                <div className="text-xs text-text-muted text-center">
+                  Dropped lines: {scanStatus.droppedLines}
+                </div>
+              )}
             </div>
           )}
 
@@ -208,6 +283,38 @@ const LinearDetectorImaging = ({ disabled = false }) => {
                 className="w-full px-3 py-2 border-2 border-border rounded-lg bg-background-white dark:bg-background-secondary text-text dark:text-text outline-none focus:border-primary focus:ring-2 focus:ring-primary/20 transition-all disabled:bg-gray-100 disabled:cursor-not-allowed"
               />
             </div>
+
+            <div>
+              <label className="text-sm font-medium text-text dark:text-text mb-2 block">
+                {t('lineWidth') || 'Line Width'} (px)
+              </label>
+              <input
+                type="number"
+                value={settings.lineWidth}
+                onChange={(e) => handleParamChange('lineWidth', e.target.value)}
+                disabled={disabled || scanStatus.isScanning}
+                min="16"
+                max="8192"
+                step="16"
+                className="w-full px-3 py-2 border-2 border-border rounded-lg bg-background-white dark:bg-background-secondary text-text dark:text-text outline-none focus:border-primary focus:ring-2 focus:ring-primary/20 transition-all disabled:bg-gray-100 disabled:cursor-not-allowed"
+              />
+            </div>
+
+            <div>
+              <label className="text-sm font-medium text-text dark:text-text mb-2 block">
+                {t('lineRate') || 'Line Rate'} (Hz)
+              </label>
+              <input
+                type="number"
+                value={settings.lineRate}
+                onChange={(e) => handleParamChange('lineRate', e.target.value)}
+                disabled={disabled || scanStatus.isScanning}
+                min="1"
+                max="200000"
+                step="1000"
+                className="w-full px-3 py-2 border-2 border-border rounded-lg bg-background-white dark:bg-background-secondary text-text dark:text-text outline-none focus:border-primary focus:ring-2 focus:ring-primary/20 transition-all disabled:bg-gray-100 disabled:cursor-not-allowed"
+              />
+            </div>
           </div>
 
           {/* Summary Panel */}
@@ -1,4 +1,4 @@
-import React, { useState, useEffect } from 'react';
+import React, { useState, useEffect, useRef } from 'react';
 import { useTranslation } from 'react-i18next';
 import {
   Shield,
@@ -8,11 +8,17 @@ import {
   AlertCircle,
   CheckCircle,
   XCircle,
-  Gauge
+  Gauge,
+  Activity
 } from 'lucide-react';
+import { useWebSocket } from '../contexts/WebSocketContext';
+
+// هشدار کیفیت به اندازه فاصله تکرار هشدار در backend (alertRepeatIntervalMs) نگه داشته می‌شه
+const ALERT_LATCH_MS = 10000;
 
 const SystemStabilityCheck = ({ onStatusChange }) => {
   const { t } = useTranslation();
+  const { addMessageCallback } = useWebSocket();
 
   // وضعیت‌های مختلف سیستم
   const [systemStatus, setSystemStatus] = useState({
@@ -21,8 +27,62 @@ const SystemStabilityCheck = ({ onStatusChange }) => {
     voltage: { status: 'ok', value: 220, message: '' },
     pressure: { status: 'ok', value: 1.0, message: '' },
     cooling: { status: 'ok', value: 'Active', message: '' },
+    detectorDrift: { status: 'unknown', value: '-', message: '' },
   });
 
+  // drift گزارش‌شده و آخرین هشدار جدا نگه داشته می‌شن تا گزارش بعدی هشدار رو پاک نکنه
+  const driftRef = useRef(systemStatus.detectorDrift);
+  const alertRef = useRef(null); // { message, expiresAt }
+
+  const composeDetectorDrift = () => {
+    const drift = driftRef.current;
+    const alert = alertRef.current;
+    if (!alert || Date.now() >= alert.expiresAt) return drift;
+    return {
+      ...drift,
+      status: drift.status === 'error' ? 'error' : 'warning',
+      message: alert.message
+    };
+  };
+
+  const publishDetectorDrift = () => {
+    setSystemStatus(prev => ({ ...prev, detectorDrift: composeDetectorDrift() }));
+  };
+
+  // پایداری آشکارساز از backend: drift میانگین/gain/نویز (quality:{json}) و هشدارها (qualityAlert:{json})
+  useEffect(() => {
+    const handleQualityMessage = (message) => {
+      if (typeof message !== 'string') return;
+      try {
+        if (message.startsWith('quality:')) {
+          const { drift, source } = JSON.parse(message.slice(8));
+          if (!drift?.ready) return;
+          const worst = Math.max(Math.abs(drift.mean), Math.abs(drift.gain), Math.abs(drift.noise));
+          // داده شبیه‌سازی‌شده نمایش داده میشه ولی در وضعیت کلی سیستم حساب نمیشه
+          if (source === 'simulated') {
+            driftRef.current = { status: 'unknown', value: worst.toFixed(2), message: 'Simulated source' };
+            publishDetectorDrift();
+            return;
+          }
+          driftRef.current = {
+            status: worst < 2 ? 'ok' : worst < 5 ? 'warning' : 'error',
+            value: worst.toFixed(2),
+            message: worst < 2 ? '' : `mean ${drift.mean.toFixed(1)}%, gain ${drift.gain.toFixed(1)}%, noise ${drift.noise.toFixed(1)}%`
+          };
+          publishDetectorDrift();
+        } else if (message.startsWith('qualityAlert:')) {
+          const alert = JSON.parse(message.slice(13));
+          alertRef.current = { message: alert.message, expiresAt: Date.now() + ALERT_LATCH_MS };
+          publishDetectorDrift();
+        }
+      } catch (error) {
+        console.error('❌ Invalid quality message:', error);
+      }
+    };
+
+    return addMessageCallback(handleQualityMessage);
+  }, [addMessageCallback]);
+
   // شبیه‌سازی دریافت داده از backend
   useEffect(() => {
     const interval = setInterval(() => {
@@ -58,16 +118,18 @@ const SystemStabilityCheck = ({ onStatusChange }) => {
         },
       };
 
-      setSystemStatus(newStatus);
+      // detectorDrift از backend می‌آید، نه از شبیه‌سازی
+      const merged = { ...newStatus, detectorDrift: composeDetectorDrift() };
+      setSystemStatus(merged);
 
       // اطلاع به والد در مورد وضعیت کلی
-      const hasError = Object.values(newStatus).some(s => s.status === 'error');
-      const hasWarning = Object.values(newStatus).some(s => s.status === 'warning');
+      const hasError = Object.values(merged).some(s => s.status === 'error');
+      const hasWarning = Object.values(merged).some(s => s.status === 'warning');
 
       if (onStatusChange) {
         onStatusChange({
           overallStatus: hasError ? 'error' : hasWarning ? 'warning' : 'ok',
-          details: newStatus
+          details: merged
         });
       }
     }, 2000);
@@ -134,6 +196,12 @@ const SystemStabilityCheck = ({ onStatusChange }) => {
       label: t('coolingSystem') || 'Cooling System',
       icon: Shield,
       unit: ''
+    },
+    {
+      key: 'detectorDrift',
+      label: t('detectorDrift') || 'Detector Drift',
+      icon: Activity,
+      unit: '%'
     }
   ];
 
@@ -1,12 +1,15 @@
 import React, { createContext, useContext, useState, useCallback, useEffect, useMemo, useRef } from 'react';
 import { useWebSocket } from './WebSocketContext';
+import { useWebChannel } from './WebChannelContext';
 import debugLogger from '../utils/debugLogger';
 
 const CameraContext = createContext();
 
 export const CameraProvider = ({ children }) => {
   // Get WebSocket context
-  const { isConnected, connectionStatus, addMessageCallback } = useWebSocket();
+  const { isConnected, connectionStatus, addMessageCallback, send } = useWebSocket();
+  // Embedded QWebEngineView gets frames in-process instead of over WebSocket
+  const { frames: localFrameSource } = useWebChannel() || {};
 
   // Log render
   debugLogger.logRender('CameraProvider', { connectionStatus });
@@ -72,6 +75,55 @@ export const CameraProvider = ({ children }) => {
   // State برای تاریخچه تغییرات
   const [history, setHistory] = useState([]);
 
+  // Store a new frame in refs and notify listeners (shared by WebSocket and local paths)
+  const publishFrame = useCallback((channel, frameData) => {
+    const now = Date.now();
+
+    // Update refs directly (no re-render)
+    const currentChannel = cameraFramesRef.current[channel];
+    const newFrameCount = currentChannel.frameCount + 1;
+
+    // Calculate FPS every 5 seconds
+    let avgFps = currentChannel.avgFps;
+    let lastFpsCalculation = currentChannel.lastFpsCalculation;
+
+    if (now - lastFpsCalculation >= 5000) { // 5 seconds
+      if (lastFpsCalculation > 0) {
+        const timeDiff = (now - lastFpsCalculation) / 1000;
+        const framesSinceLastCalc = newFrameCount - (currentChannel.frameCount - newFrameCount + 1);
+        avgFps = Math.round((framesSinceLastCalc / timeDiff) * 10) / 10;
+      }
+      lastFpsCalculation = now;
+    }
+
+    // Update ref data
+    cameraFramesRef.current[channel] = {
+      currentFrame: frameData,
+      lastUpdate: now,
+      frameCount: newFrameCount,
+      avgFps,
+      lastFpsCalculation
+    };
+
+    // Update connection status if needed (only once when connecting)
+    if (!connectionStatusRef.current[channel]) {
+      connectionStatusRef.current[channel] = true;
+      setCameraStatus(prev => ({
+        ...prev,
+        [channel]: { isConnected: true }
+      }));
+    }
+
+    // Notify registered components via callbacks (no re-render)
+    frameCallbacksRef.current.forEach(callback => {
+      try {
+        callback(channel);
+      } catch (err) {
+        console.error('Frame callback error:', err);
+      }
+    });
+  }, []);
+
   // Handle WebSocket messages for camera frames
   useEffect(() => {
     const handleCameraMessage = (message) => {
@@ -84,6 +136,9 @@ export const CameraProvider = ({ children }) => {
 
         if (typeof message !== 'string') return;
 
+        // Line-scan rows/status go to LinearDetectorImaging, quality reports to the quality panels
+        if (message.startsWith('linescan') || message.startsWith('quality')) return;
+
         const colonIndex = message.indexOf(':');
         if (colonIndex === -1) return;
 
@@ -97,52 +152,7 @@ export const CameraProvider = ({ children }) => {
           return;
         }
 
-        const frameData = `data:image/jpeg;base64,${base64Data}`;
-        const now = Date.now();
-
-        // Update refs directly (no re-render)
-        const currentChannel = cameraFramesRef.current[channel];
-        const newFrameCount = currentChannel.frameCount + 1;
-
-        // Calculate FPS every 5 seconds
-        let avgFps = currentChannel.avgFps;
-        let lastFpsCalculation = currentChannel.lastFpsCalculation;
-
-        if (now - lastFpsCalculation >= 5000) { // 5 seconds
-          if (lastFpsCalculation > 0) {
-            const timeDiff = (now - lastFpsCalculation) / 1000;
-            const framesSinceLastCalc = newFrameCount - (currentChannel.frameCount - newFrameCount + 1);
-            avgFps = Math.round((framesSinceLastCalc / timeDiff) * 10) / 10;
-          }
-          lastFpsCalculation = now;
-        }
-
-        // Update ref data
-        cameraFramesRef.current[channel] = {
-          currentFrame: frameData,
-          lastUpdate: now,
-          frameCount: newFrameCount,
-          avgFps,
-          lastFpsCalculation
-        };
-
-        // Update connection status if needed (only once when connecting)
-        if (!connectionStatusRef.current[channel]) {
-          connectionStatusRef.current[channel] = true;
-          setCameraStatus(prev => ({
-            ...prev,
-            [channel]: { isConnected: true }
-          }));
-        }
-
-        // Notify registered components via callbacks (no re-render)
-        frameCallbacksRef.current.forEach(callback => {
-          try {
-            callback(channel);
-          } catch (err) {
-            console.error('Frame callback error:', err);
-          }
-        });
+        publishFrame(channel, `data:image/jpeg;base64,${base64Data}`);
 
       } catch (error) {
         console.error('❌ Error processing camera message:', error);
@@ -158,7 +168,82 @@ export const CameraProvider = ({ children }) => {
         unsubscribe();
       }
     };
-  }, [addMessageCallback]);
+  }, [addMessageCallback, publishFrame]);
+
+  // Local fast path: backend announces frames via QWebChannel and serves the
+  // encoded JPEG from ct2frame:<channel>. Fetched into a same-origin blob URL
+  // so canvas getImageData() keeps working. WebSocket frames are only turned
+  // off after a local fetch succeeds, and turned back on if fetches keep failing.
+  useEffect(() => {
+    if (!localFrameSource || !isConnected) return;
+
+    const MAX_LOCAL_FAILURES = 3;
+    const objectUrls = { basler: [], monitoring: [] };
+    const inFlight = { basler: false, monitoring: false };
+    let active = true;
+    let optedIn = false;
+    let failures = 0;
+
+    const handleLocalFailure = (reason) => {
+      failures += 1;
+      if (failures < MAX_LOCAL_FAILURES) return;
+
+      console.warn('⚠️ Local frame path unavailable, staying on WebSocket:', reason);
+      active = false;
+      localFrameSource.frameReady.disconnect(handleFrameReady);
+      if (optedIn) {
+        optedIn = false;
+        send('FrameTransport:websocket');
+      }
+    };
+
+    const handleFrameReady = async (channel, sequence) => {
+      if (!active || !(channel in inFlight) || inFlight[channel]) return; // drop frames while busy
+      inFlight[channel] = true;
+      try {
+        const response = await fetch(`ct2frame:${channel}?seq=${sequence}`);
+        if (!active) return;
+        if (!response.ok) {
+          handleLocalFailure(`HTTP ${response.status}`);
+          return;
+        }
+        const url = URL.createObjectURL(await response.blob());
+        failures = 0;
+
+        // Keep the previous URL alive for consumers still decoding it
+        const urls = objectUrls[channel];
+        urls.push(url);
+        if (urls.length > 2) {
+          URL.revokeObjectURL(urls.shift());
+        }
+        publishFrame(channel, url);
+
+        if (!optedIn) {
+          optedIn = true;
+          send('FrameTransport:local');
+        }
+      } catch (error) {
+        if (active) {
+          handleLocalFailure(error);
+        }
+      } finally {
+        inFlight[channel] = false;
+      }
+    };
+
+    localFrameSource.frameReady.connect(handleFrameReady);
+
+    return () => {
+      if (active) {
+        localFrameSource.frameReady.disconnect(handleFrameReady);
+      }
+      active = false;
+      if (optedIn) {
+        send('FrameTransport:websocket');
+      }
+      Object.values(objectUrls).forEach(urls => urls.forEach(url => URL.revokeObjectURL(url)));
+    };
+  }, [localFrameSource, isConnected, send, publishFrame]);
 
   // Update camera connection status based on WebSocket status
   useEffect(() => {
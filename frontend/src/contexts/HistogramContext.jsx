@@ -1,7 +1,11 @@
-import { createContext, useContext, useState, useCallback, useEffect } from 'react';
+import { createContext, useContext, useState, useCallback, useEffect, useRef } from 'react';
+import { useWebSocket } from './WebSocketContext';
 
 const HistogramContext = createContext();
 
+// حداقل فاصله ارسال DisplaySettings هنگام drag کردن دسته‌ها (ms)
+const DISPLAY_SETTINGS_INTERVAL_MS = 50;
+
 export const useHistogram = () => {
   const context = useContext(HistogramContext);
   if (!context) {
@@ -11,6 +15,7 @@ export const useHistogram = () => {
 };
 
 export const HistogramProvider = ({ children }) => {
+  const { send, isConnected } = useWebSocket();
   const [histogramData, setHistogramData] = useState(null);
   const [selectedPoint, setSelectedPoint] = useState(null);
   const [currentChannel, setCurrentChannel] = useState('gray');
@@ -128,6 +133,32 @@ export const HistogramProvider = ({ children }) => {
     setWindowWidth(maxValue);
   }, [bitDepth]);
 
+  // Window/Level سمت سرور: backend فقط یک LUT می‌سازه و فریم‌های basler رو
+  // Window/Level شده می‌فرسته، پس پاس JS روی پیکسل‌ها (useWindowLevel) لازم نیست
+  const [isServerWindowLevel, setIsServerWindowLevel] = useState(false);
+  const lastDisplaySendRef = useRef(0);
+
+  useEffect(() => {
+    if (!isConnected) {
+      setIsServerWindowLevel(false);
+      return;
+    }
+
+    const defaultMax = bitDepth === 16 ? 65535 : 255;
+    const active = isWindowLevelApplied && !(minLevel === 0 && maxLevel === defaultMax);
+
+    // Throttle: هنگام drag حداکثر یک پیام در هر بازه، مقدار نهایی همیشه ارسال میشه
+    const wait = Math.max(0, DISPLAY_SETTINGS_INTERVAL_MS - (Date.now() - lastDisplaySendRef.current));
+    const timer = setTimeout(() => {
+      lastDisplaySendRef.current = Date.now();
+      const settings = active ? JSON.stringify({ bitDepth, minLevel, maxLevel }) : '{}';
+      const sent = send('DisplaySettings:' + settings);
+      setIsServerWindowLevel(active && sent);
+    }, wait);
+
+    return () => clearTimeout(timer);
+  }, [minLevel, maxLevel, bitDepth, isWindowLevelApplied, isConnected, send]);
+
   // Callback برای اطلاع به کامپوننت‌ها هنگام تغییر Window/Level
   // این callback رو BaslerDisplay میتونه استفاده کنه
   const [windowLevelCallback, setWindowLevelCallback] = useState(null);
@@ -160,6 +191,7 @@ export const HistogramProvider = ({ children }) => {
         bitDepth,
         lut,
         isWindowLevelApplied,
+        isServerWindowLevel,
 
         // توابع
         updateHistogram,
@@ -5,14 +5,19 @@ const WebChannelContext = createContext();
 
 export const WebChannelProvider = ({ children }) => {
   const [backend, setBackend] = useState(null);
+  // In-process frame source (LocalFrameServer) - only present in the embedded view
+  const [frames, setFrames] = useState(null);
 
   useEffect(() => {
     const initWebChannel = () => {
       if (window.qt && window.qt.webChannelTransport && window.QWebChannel) {
         new window.QWebChannel(window.qt.webChannelTransport, (channel) => {
+          if (channel?.objects?.frames) {
+            setFrames(channel.objects.frames);
+          }
           if (channel?.objects?.backend) {
             setBackend(channel.objects.backend);
-          } else {
+          } else if (!channel?.objects?.frames) {
             console.error("WebChannel backend object not found.");
           }
         });
@@ -26,7 +31,7 @@ export const WebChannelProvider = ({ children }) => {
   }, []);
 
   return (
-    <WebChannelContext.Provider value={{ backend }}>
+    <WebChannelContext.Provider value={{ backend, frames }}>
       {children}
     </WebChannelContext.Provider>
   );
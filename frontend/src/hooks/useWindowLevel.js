@@ -19,6 +19,7 @@ export function useWindowLevel(canvasRef, enabled = true) {
     maxLevel,
     bitDepth,
     isWindowLevelApplied,
+    isServerWindowLevel,
   } = useHistogram();
 
   // ذخیره تصویر اصلی
@@ -49,6 +50,12 @@ export function useWindowLevel(canvasRef, enabled = true) {
       return;
     }
 
+    // backend فریم‌ها رو Window/Level شده می‌فرسته؛ پاس دوم روی پیکسل‌ها لازم نیست
+    if (isServerWindowLevel) {
+      originalImageDataRef.current = null;
+      return;
+    }
+
     const canvas = canvasRef.current;
 
     // ذخیره تصویر اصلی (اگر هنوز ذخیره نشده)
@@ -61,7 +68,7 @@ export function useWindowLevel(canvasRef, enabled = true) {
     console.log('✨ Applying Window/Level:', { minLevel, maxLevel, bitDepth });
     applyWindowLevel(canvas, minLevel, maxLevel, bitDepth, originalImageDataRef.current);
 
-  }, [canvasRef, minLevel, maxLevel, bitDepth, isWindowLevelApplied, enabled]);
+  }, [canvasRef, minLevel, maxLevel, bitDepth, isWindowLevelApplied, isServerWindowLevel, enabled]);
 
   // پاک کردن هنگام unmount
   useEffect(() => {